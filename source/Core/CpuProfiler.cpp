@@ -0,0 +1,145 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#include <cstdio>
+#include <tuple>
+#include "CpuProfiler.h"
+#include "Graphics/GfxProfiler.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace
+	{
+		void WriteEscaped(FILE* file, char const* str)
+		{
+			for (; *str; ++str)
+			{
+				if (*str == '"' || *str == '\\') fputc('\\', file);
+				if (static_cast<unsigned char>(*str) >= 0x20) fputc(*str, file);
+			}
+		}
+	}
+
+	thread_local CpuProfiler::ThreadEvents* CpuProfiler::local_events = nullptr;
+
+	CpuProfiler::CpuProfiler() : calibration_ticks(CpuProfilerTicks()), calibration_time(std::chrono::steady_clock::now())
+	{
+		gpu_events.resize(MAX_GPU_EVENTS);
+	}
+
+	void CpuProfiler::Enable(bool enable)
+	{
+		if (enable == IsEnabled()) return;
+		if (enable) capture_begin.store(CpuProfilerTicks());
+		enabled.store(enable);
+	}
+
+	void CpuProfiler::SetThreadName(std::string const& name)
+	{
+		ThreadEvents& events = LocalThreadEvents();
+		std::scoped_lock lock(threads_mutex);
+		events.thread_name = name;
+	}
+
+	void CpuProfiler::RecordScope(char const* name, uint64_t begin, uint64_t end)
+	{
+		ThreadEvents& events = LocalThreadEvents();
+		uint64_t const head = events.head.load(std::memory_order_relaxed);
+		ScopeEvent& event = events.events[head & (EVENTS_PER_THREAD - 1)];
+		event.name.store(name, std::memory_order_relaxed);
+		event.begin.store(begin, std::memory_order_relaxed);
+		event.end.store(end, std::memory_order_relaxed);
+		events.head.store(head + 1, std::memory_order_release);
+	}
+
+	void CpuProfiler::RecordGpuFrame(uint64_t frame_begin, std::span<Timestamp const> timestamps)
+	{
+		if (!IsEnabled()) return;
+		std::scoped_lock lock(gpu_mutex);
+		for (Timestamp const& timestamp : timestamps)
+		{
+			gpu_events[gpu_head++ & (MAX_GPU_EVENTS - 1)] = GpuEvent{ timestamp.name, frame_begin, timestamp.start_in_ms, timestamp.time_in_ms };
+		}
+	}
+
+	bool CpuProfiler::ExportChromeTrace(std::string const& file_path)
+	{
+		FILE* file = fopen(file_path.c_str(), "w");
+		if (!file) return false;
+
+		uint64_t const trace_begin = capture_begin.load();
+		double const elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - calibration_time).count();
+		double const ticks_per_us = elapsed_us > 0.0 ? (CpuProfilerTicks() - calibration_ticks) / elapsed_us : 1.0;
+		auto ToMicroseconds = [&](uint64_t ticks) { return (static_cast<double>(ticks) - static_cast<double>(trace_begin)) / ticks_per_us; };
+
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+		fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"GPU\"}}", file);
+
+		std::vector<std::tuple<char const*, uint64_t, uint64_t>> events;
+		std::scoped_lock lock(threads_mutex);
+		for (auto const& thread : threads)
+		{
+			fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", thread->thread_id);
+			WriteEscaped(file, thread->thread_name.c_str());
+			fputs("\"}}", file);
+
+			//seqlock style read: copy the ring, then drop whatever the owner may have overwritten meanwhile
+			uint64_t const head = thread->head.load(std::memory_order_acquire);
+			uint64_t const first = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+			events.clear();
+			for (uint64_t i = first; i < head; ++i)
+			{
+				ScopeEvent const& event = thread->events[i & (EVENTS_PER_THREAD - 1)];
+				events.emplace_back(event.name.load(std::memory_order_relaxed), event.begin.load(std::memory_order_relaxed), event.end.load(std::memory_order_relaxed));
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t const overwritten = thread->head.load(std::memory_order_relaxed) + 1;
+			uint64_t const valid_first = overwritten > EVENTS_PER_THREAD ? overwritten - EVENTS_PER_THREAD : 0;
+
+			for (uint64_t i = (std::max)(first, valid_first); i < head; ++i)
+			{
+				auto const& [name, begin, end] = events[i - first];
+				if (begin < trace_begin) continue;
+				fputs(",\n{\"name\":\"", file);
+				WriteEscaped(file, name);
+				fprintf(file, "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread->thread_id, ToMicroseconds(begin), (end - begin) / ticks_per_us);
+			}
+		}
+
+		{
+			std::scoped_lock gpu_lock(gpu_mutex);
+			uint64_t const first = gpu_head > MAX_GPU_EVENTS ? gpu_head - MAX_GPU_EVENTS : 0;
+			for (uint64_t i = first; i < gpu_head; ++i)
+			{
+				GpuEvent const& event = gpu_events[i & (MAX_GPU_EVENTS - 1)];
+				if (event.frame_begin < trace_begin) continue;
+				fputs(",\n{\"name\":\"", file);
+				WriteEscaped(file, event.name.c_str());
+				fprintf(file, "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}", ToMicroseconds(event.frame_begin) + event.start_in_ms * 1000.0, event.time_in_ms * 1000.0);
+			}
+		}
+
+		fputs("\n]}\n", file);
+		return fclose(file) == 0;
+	}
+
+	CpuProfiler::ThreadEvents& CpuProfiler::LocalThreadEvents()
+	{
+		if (!local_events)
+		{
+			std::scoped_lock lock(threads_mutex);
+			ThreadEvents& events = *threads.emplace_back(std::make_unique<ThreadEvents>());
+			events.thread_id = static_cast<uint32_t>(threads.size());
+			events.thread_name = "Thread " + std::to_string(events.thread_id);
+			local_events = &events;
+		}
+		return *local_events;
+	}
+
+}
\ No newline at end of file
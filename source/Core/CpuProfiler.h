@@ -0,0 +1,126 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <span>
+#include <chrono>
+#if defined(_M_X64)
+#include <intrin.h>
+#endif
+#include "Core/Defines.h"
+#include "Utilities/Singleton.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	struct Timestamp;
+
+	//raw ticks of the profiler clock: rdtsc on x64, steady_clock elsewhere. converted to time only on export
+	inline uint64_t CpuProfilerTicks()
+	{
+#if defined(_M_X64)
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	//every thread records closed scopes into its own ring, nothing is shared on the recording path.
+	//while disabled a scope costs one relaxed load, so the macros stay compiled into release builds
+	class CpuProfiler : public Singleton<CpuProfiler>
+	{
+		friend class Singleton<CpuProfiler>;
+
+		static constexpr uint64_t EVENTS_PER_THREAD = 1 << 16;
+		static constexpr uint64_t MAX_GPU_EVENTS = 1 << 14;
+
+		struct ScopeEvent
+		{
+			std::atomic<char const*> name = nullptr;
+			std::atomic<uint64_t> begin = 0;
+			std::atomic<uint64_t> end = 0;
+		};
+
+		struct ThreadEvents
+		{
+			uint32_t thread_id = 0;
+			std::string thread_name;
+			std::unique_ptr<ScopeEvent[]> events = std::make_unique<ScopeEvent[]>(EVENTS_PER_THREAD);
+			std::atomic<uint64_t> head = 0;
+		};
+
+		struct GpuEvent
+		{
+			std::string name;
+			uint64_t frame_begin;
+			float start_in_ms;
+			float time_in_ms;
+		};
+
+	public:
+		static bool IsEnabled()
+		{
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		//enabling starts a new capture, only scopes that begin after it are exported
+		void Enable(bool enable);
+		void SetThreadName(std::string const& name);
+
+		void RecordScope(char const* name, uint64_t begin, uint64_t end);
+		//gpu timestamps are placed relative to the cpu tick taken when their frame started recording
+		void RecordGpuFrame(uint64_t frame_begin, std::span<Timestamp const> timestamps);
+
+		bool ExportChromeTrace(std::string const& file_path);
+
+	private:
+		inline static std::atomic<bool> enabled = false;
+		static thread_local ThreadEvents* local_events;
+
+		std::mutex threads_mutex;
+		std::vector<std::unique_ptr<ThreadEvents>> threads;
+
+		std::mutex gpu_mutex;
+		std::vector<GpuEvent> gpu_events;
+		uint64_t gpu_head = 0;
+
+		std::atomic<uint64_t> capture_begin = 0;
+		uint64_t calibration_ticks;
+		std::chrono::steady_clock::time_point calibration_time;
+
+	private:
+		CpuProfiler();
+		~CpuProfiler() = default;
+
+		ThreadEvents& LocalThreadEvents();
+	};
+	#define g_CpuProfiler CpuProfiler::Get()
+
+#if CPU_PROFILING
+	struct CpuProfileScope
+	{
+		explicit CpuProfileScope(char const* name) : name{ name }, begin{ CpuProfiler::IsEnabled() ? CpuProfilerTicks() : 0 } {}
+
+		~CpuProfileScope()
+		{
+			if (begin) g_CpuProfiler.RecordScope(name, begin, CpuProfilerTicks());
+		}
+
+		char const* name;
+		uint64_t begin;
+	};
+	#define CaseEngineCpuProfileScope(name) CpuProfileScope CASE_ENGINE_CONCAT(cpu_profile, __COUNTER__)(name)
+#else
+	#define CaseEngineCpuProfileScope(name) 
+#endif
+}
\ No newline at end of file
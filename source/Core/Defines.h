@@ -29,4 +29,6 @@
 #define CASE_ENGINE_NORETURN				[[noreturn]]
 #define CASE_ENGINE_DEPRECATED			[[deprecated]]
 #define CASE_ENGINE_DEPRECATED_MSG(msg)	[[deprecated(#msg)]]
-#define CASE_ENGINE_ALIGN(align)           alignas(align) 
\ No newline at end of file
+#define CASE_ENGINE_ALIGN(align)           alignas(align) 
+
+#define CPU_PROFILING 1
\ No newline at end of file
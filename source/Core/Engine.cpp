@@ -9,12 +9,16 @@
 #include "Math/Constants.h"
 #include "Core/Logger.h"
 #include "Core/Paths.h"
+#include "Core/CpuProfiler.h"
 #include "Editors/GUI.h"
 #include "Graphics/GfxDevice.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/ModelImporter.h"
+#include "Rendering/ComponentsSnapshot.h"
 #include "Rendering/ShaderManager.h"
 #include "Utilities/ThreadPool.h"
+#include "Utilities/Task.h"
+#include "Utilities/FrameArena.h"
 #include "Utilities/Random.h"
 #include "Utilities/Timer.h"
 #include "Utilities/JsonUtil.h"
@@ -215,7 +219,9 @@ namespace Case_Engine
 
 	Engine::Engine(const EngineInit &init) : window(init.window), vsync{ init.vsync }, scene_viewport_data{}
 	{
-		g_ThreadPool.Initialize();
+		g_CpuProfiler.SetThreadName("Main");
+		g_ThreadPool.Initialize(init.thread_pool_init);
+		g_TaskScheduler.Initialize();
 
 		gfx = std::make_unique<GfxDevice>(window);
 		g_TextureManager.Initialize(gfx.get());
@@ -260,19 +266,24 @@ namespace Case_Engine
 
 	void Engine::Run(const RendererSettings &settings)
 	{
+		CaseEngineCpuProfileScope("Frame");
 		static Timer timer;
 		float const dt = timer.MarkInSeconds();
 
+		g_TaskScheduler.RunMainThreadContinuations();
 		g_Input.Tick();
 		if (window->IsActive())
 		{
 			Update(dt);
 			Render(settings);
 		}
+		FrameArena::NextFrame();
 	}
 
 	void Engine::Update(float dt)
 	{
+		CaseEngineCpuProfileScope("Update");
+		reg.advance_tick();
 		camera->Tick(dt);
 		renderer->SetSceneViewportData(scene_viewport_data);
 		renderer->Tick(camera.get());
@@ -281,6 +292,7 @@ namespace Case_Engine
 
 	void Engine::Render(const RendererSettings &settings)
 	{
+		CaseEngineCpuProfileScope("Render");
 		renderer->Render(settings);
 		if (editor_active)
 		{
@@ -319,10 +331,27 @@ namespace Case_Engine
 		gfx->SwapBuffers(vsync);
 	}
 
+	void Engine::SaveSnapshot()
+	{
+		scene_snapshot.clear();
+		SaveSceneSnapshot(reg, scene_snapshot);
+	}
+
+	void Engine::RestoreSnapshot()
+	{
+		if (scene_snapshot.empty()) return;
+		scene_snapshot.rewind();
+		LoadSceneSnapshot(reg, scene_snapshot);
+	}
+
 	void Engine::InitializeScene(const SceneConfig &config)
 	{
 		model_importer->LoadSkybox(config.skybox_params);
-		for (auto&& model : config.scene_models) model_importer->ImportModel_GLTF(model);
+		std::vector<Task<std::vector<tecs::entity>>> model_imports;
+		model_imports.reserve(config.scene_models.size());
+		for (auto&& model : config.scene_models) model_imports.push_back(model_importer->ImportModelAsync_GLTF(model));
+		for (auto& model_import : model_imports) model_import.Start();
+		for (auto& model_import : model_imports) std::ignore = model_import.Get();
 		for (auto&& light : config.scene_lights) model_importer->LoadLight(light);
 	}
 }
\ No newline at end of file
@@ -9,9 +9,11 @@
 #include <optional>
 #include "Input.h"
 #include "tecs/registry.h"
+#include "tecs/snapshot.h"
 #include "Rendering/Camera.h"
 #include "Rendering/RendererSettings.h"
 #include "Rendering/SceneViewport.h"
+#include "Utilities/ThreadPool.h"
 
 
 // Namespace Case_Engine
@@ -29,6 +31,7 @@ namespace Case_Engine
 		bool vsync = false;
 		Window* window = nullptr;
 		std::string scene_file = "scene.json";
+		ThreadPoolInit thread_pool_init{};
 	};
 
 	struct SceneConfig;
@@ -58,6 +61,7 @@ namespace Case_Engine
 
 		Window* window = nullptr;
 		tecs::registry reg;
+		tecs::snapshot_archive scene_snapshot;
 		std::unique_ptr<GfxDevice> gfx;
 		std::unique_ptr<Renderer> renderer;
 		std::unique_ptr<ModelImporter> model_importer;
@@ -72,6 +76,8 @@ namespace Case_Engine
 		void Update(float dt);
 		void Render(const RendererSettings &settings);
 		void SetSceneViewportData(std::optional<SceneViewport> viewport_data);
+		void SaveSnapshot();
+		void RestoreSnapshot();
 
 	};
 }
\ No newline at end of file
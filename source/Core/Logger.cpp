@@ -51,7 +51,7 @@ namespace Case_Engine
 
 	LogManager::~LogManager()
 	{
-		exit.store(true);
+		log_queue.Close();
 		log_thread.join();
 	}
 
@@ -74,14 +74,9 @@ namespace Case_Engine
 	void LogManager::ProcessLogs()
 	{
 		QueueEntry entry{};
-		while (true)
+		while (log_queue.WaitPop(entry))
 		{
-			bool success = log_queue.TryPop(entry);
-			if (success)
-			{
-				for (auto&& logger : loggers) if (logger) logger->Log(entry.level, entry.str.c_str(), entry.filename.c_str(), entry.line);
-			}
-			if (exit.load() && log_queue.Empty()) break;
+			for (auto&& logger : loggers) if (logger) logger->Log(entry.level, entry.str.c_str(), entry.filename.c_str(), entry.line);
 		}
 	}
 
@@ -93,9 +93,8 @@ namespace Case_Engine
 
 	private:
 		std::vector<std::unique_ptr<ILogger>> loggers;
-		std::thread log_thread;
 		Case_Engine::ConcurrentQueue<QueueEntry> log_queue;
-		std::atomic_bool exit = false;
+		std::thread log_thread;
 
 	private:
 		void ProcessLogs();
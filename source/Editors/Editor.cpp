@@ -10,7 +10,9 @@
 #include "Core/Logger.h"
 #include "Core/Paths.h"
 #include "Core/Window.h"
+#include "Core/CpuProfiler.h"
 #include "Rendering/Renderer.h"
+#include "Rendering/SceneGraph.h"
 #include "Graphics/GfxDevice.h"
 #include "Utilities/StringUtil.h"
 #include "Utilities/Random.h"
@@ -135,10 +137,16 @@ namespace Case_Engine
 						if (!texture_path.empty()) texture_path.append("/");
 
 						params.textures_path = texture_path;
-						engine->model_importer->ImportModel_GLTF(params);
+						engine->model_importer->ImportModelAsync_GLTF(params).Detach();
 						free(file_path);
 					}
 				}
+				if (ImGui::MenuItem("Save Snapshot")) engine->SaveSnapshot();
+				if (ImGui::MenuItem("Restore Snapshot", 0, false, !engine->scene_snapshot.empty()))
+				{
+					engine->RestoreSnapshot();
+					selected_entity = tecs::null_entity;
+				}
 				ImGui::EndMenu();
 			}
 
@@ -280,21 +288,15 @@ namespace Case_Engine
 					aabb->UpdateBuffer(engine->gfx.get());
 				}
 
-				if (Relationship* relationship = engine->reg.get_if<Relationship>(selected_entity))
+				ForEachChild(engine->reg, selected_entity, [&](tecs::entity child)
 				{
-					for (uint32_t i = 0; i < relationship->children_count; ++i)
+					if (AABB* aabb = engine->reg.get_if<AABB>(child))
 					{
-						tecs::entity child = relationship->children[i];
-						if (AABB* aabb = engine->reg.get_if<AABB>(child))
-						{
-							aabb->bounding_box.Transform(aabb->bounding_box, entity_transform.current_transform.Invert());
-							aabb->bounding_box.Transform(aabb->bounding_box, tr);
-							aabb->UpdateBuffer(engine->gfx.get());
-
-
-						}
+						aabb->bounding_box.Transform(aabb->bounding_box, entity_transform.current_transform.Invert());
+						aabb->bounding_box.Transform(aabb->bounding_box, tr);
+						aabb->UpdateBuffer(engine->gfx.get());
 					}
-				}
+				});
 				entity_transform.current_transform = tr;
 			}
 
@@ -392,6 +394,23 @@ namespace Case_Engine
 					ImGui::Text("Total: %7.2f %s", total_time_ms, "ms");
 					state.accumulating_frame_count++;
 
+					ImGui::Separator();
+					ImGui::Text("CPU Systems");
+					for (auto const& system_timing : engine->renderer->GetSystemTimings())
+					{
+						ImGui::Text("%-18s: %7.2f %s", system_timing.name.c_str(), system_timing.time_in_ms, "ms");
+					}
+
+					ImGui::Separator();
+					static bool capture_trace = false;
+					if (ImGui::Checkbox("Capture Trace", &capture_trace)) g_CpuProfiler.Enable(capture_trace);
+					if (ImGui::Button("Export Chrome Trace"))
+					{
+						std::string const trace_path = paths::LogDir() + "case-engine-trace.json";
+						if (g_CpuProfiler.ExportChromeTrace(trace_path)) CASE_ENGINE_LOG(INFO, "Trace saved to %s", trace_path.c_str());
+						else CASE_ENGINE_LOG(ERROR, "Failed to save trace to %s", trace_path.c_str());
+					}
+
 				}
 				engine->renderer->SetProfiling(enable_profiling);
 
@@ -681,17 +700,22 @@ namespace Case_Engine
 		v_max.y += ImGui::GetWindowPos().y;
 		ImVec2 size(v_max.x - v_min.x, v_max.y - v_min.y);
 
+			if (ImGui::InputText("Search", entity_search, sizeof(entity_search), ImGuiInputTextFlags_EnterReturnsTrue))
+			{
+				if (tecs::entity found = FindEntity(entity_search); found != tecs::null_entity) selected_entity = found;
+				else CASE_ENGINE_LOG(WARNING, "No entity named %s", entity_search);
+			}
 
 			std::function<void(tecs::entity, bool)> ShowEntity;
 			ShowEntity = [&](tecs::entity e, bool first_iteration)
 				{
-					Relationship* relationship = engine->reg.get_if<Relationship>(e);
+					Relationship const* relationship = engine->reg.get_if<Relationship const>(e);
 					if (first_iteration && relationship && relationship->parent != tecs::null_entity) return;
 					auto& tag = all_entities.get(e);
 
 					ImGuiTreeNodeFlags flags = ((selected_entity == e) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
 					flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
-					bool opened = ImGui::TreeNodeEx(tag.name.c_str(), flags);
+					bool opened = ImGui::TreeNodeEx(g_NameTable.CStr(tag.name), flags);
 
 					if (ImGui::IsItemClicked())
 					{
@@ -701,13 +725,7 @@ namespace Case_Engine
 
 					if (opened)
 					{
-						if (relationship)
-						{
-							for (size_t i = 0; i < relationship->children_count; ++i)
-							{
-								ShowEntity(relationship->children[i], false);
-							}
-						}
+						ForEachChild(engine->reg, e, [&](tecs::entity child) { ShowEntity(child, false); });
 						ImGui::TreePop();
 					}
 				};
@@ -716,6 +734,29 @@ namespace Case_Engine
 		ImGui::End();
 	}
 
+	tecs::entity Editor::FindEntity(char const* name)
+	{
+		NameId const name_id = g_NameTable.Find(name);
+		if (name_id == INVALID_NAME_ID) return tecs::null_entity;
+
+		auto Lookup = [&]() -> tecs::entity
+			{
+				auto it = entity_names.find(name_id);
+				if (it == entity_names.end()) return tecs::null_entity;
+				Tag const* tag = engine->reg.get_if<Tag const>(it->second);
+				return tag && tag->name == name_id ? it->second : tecs::null_entity;
+			};
+
+		//the cache is rebuilt only when it misses or points to a stale entity
+		if (tecs::entity e = Lookup(); e != tecs::null_entity) return e;
+
+		auto tags = engine->reg.view<Tag>();
+		entity_names.clear();
+		entity_names.reserve(tags.size());
+		for (auto e : tags) entity_names.try_emplace(tags.get(e).name, e);
+		return Lookup();
+	}
+
 	void Editor::ObjectOptions()
 	{
 		if (ImGui::Begin(ICON_FA_CIRCLE " Object Options"))
@@ -727,9 +768,9 @@ namespace Case_Engine
 				{
 					char buffer[256];
 					memset(buffer, 0, sizeof(buffer));
-					std::strncpy(buffer, tag->name.c_str(), sizeof(buffer));
+					std::strncpy(buffer, g_NameTable.CStr(tag->name), sizeof(buffer) - 1);
 					if (ImGui::InputText("##Tag", buffer, sizeof(buffer)))
-						tag->name = std::string(buffer);
+						tag->name = g_NameTable.Intern(buffer);
 				}
 
 				auto light = engine->reg.get_if<Light>(selected_entity);
@@ -938,19 +979,15 @@ namespace Case_Engine
 						aabb->UpdateBuffer(engine->gfx.get());
 					}
 
-					if (Relationship* relationship = engine->reg.get_if<Relationship>(selected_entity))
+					ForEachChild(engine->reg, selected_entity, [&](tecs::entity child)
 					{
-						for (size_t i = 0; i < relationship->children_count; ++i)
+						if (AABB* aabb = engine->reg.get_if<AABB>(child))
 						{
-							tecs::entity child = relationship->children[i];
-							if (AABB* aabb = engine->reg.get_if<AABB>(child))
-							{
-								aabb->bounding_box.Transform(aabb->bounding_box, transform->current_transform.Invert());
-								aabb->bounding_box.Transform(aabb->bounding_box, tr);
-								aabb->UpdateBuffer(engine->gfx.get());
-							}
+							aabb->bounding_box.Transform(aabb->bounding_box, transform->current_transform.Invert());
+							aabb->bounding_box.Transform(aabb->bounding_box, tr);
+							aabb->UpdateBuffer(engine->gfx.get());
 						}
-					}
+					});
 					transform->current_transform = tr;
 				}
 
@@ -76,6 +76,8 @@ namespace Case_Engine
         SceneViewport scene_viewport_data;
 
         std::array<bool, Flag_Count> window_flags = { false };
+        HashMap<NameId, tecs::entity> entity_names;
+        char entity_search[128] = {};
 
 
 	private:
@@ -84,6 +86,7 @@ namespace Case_Engine
         void MenuBar();
         void ObjectOptions();
         void SceneObjects();
+        tecs::entity FindEntity(char const* name);
         void Explorer();
         void Scene();
 		void World();
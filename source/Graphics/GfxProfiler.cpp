@@ -9,6 +9,7 @@
 #include "GfxDevice.h"
 #include "GfxCommandContext.h"
 #include "Core/Logger.h"
+#include "Core/CpuProfiler.h"
 
 
 // Namespace Case_Engine
@@ -39,6 +40,7 @@ namespace Case_Engine
 		scope_counter = 0;
 
 		uint64_t i = current_frame % FRAME_COUNT;
+		frame_cpu_ticks[i] = CpuProfilerTicks();
 		for (auto& block : queries[i])
 		{
 			block.begin_called = false;
@@ -91,7 +93,9 @@ namespace Case_Engine
 		QueryDataTimestampDisjoint disjoint_ts{};
 
 		std::vector<Timestamp> results{};
+		std::vector<uint64_t> begin_timestamps{};
 		results.reserve(name_to_index_map.size());
+		begin_timestamps.reserve(name_to_index_map.size());
 		for (auto const& [name, index] : name_to_index_map)
 		{
 			CASE_ENGINE_ASSERT(index < MAX_QUERIES);
@@ -125,11 +129,19 @@ namespace Case_Engine
 					std::string result = name + " time: " + time_ms_string + "ms";
 
 					results.push_back(Timestamp{ .name = name, .time_in_ms = time_ms });
+					begin_timestamps.push_back(begin_ts);
 				}
 			}
 			query.begin_called = false;
 			query.end_called = false;
 		}
+
+		if (!results.empty())
+		{
+			uint64_t const first_ts = *std::min_element(begin_timestamps.begin(), begin_timestamps.end());
+			for (size_t i = 0; i < results.size(); ++i) results[i].start_in_ms = (begin_timestamps[i] - first_ts) * 1000.0f / disjoint_ts.frequency;
+			g_CpuProfiler.RecordGpuFrame(frame_cpu_ticks[old_index], results);
+		}
 		return results;
 	}
 
@@ -20,6 +20,7 @@ namespace Case_Engine
 	{
 		std::string name;
 		float time_in_ms;
+		float start_in_ms = 0.0f;	//relative to the first scope of the frame
 	};
 
 	class GfxDevice;
@@ -53,6 +54,7 @@ namespace Case_Engine
 		GfxDevice* gfx = nullptr;
 		uint64_t current_frame = 0;
 		std::array<std::array<QueryData, MAX_QUERIES>, FRAME_COUNT> queries;
+		std::array<uint64_t, FRAME_COUNT> frame_cpu_ticks{};
 		std::unordered_map<std::string, uint32_t> name_to_index_map;
 		uint32_t scope_counter = 0;
 
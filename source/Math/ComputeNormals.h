@@ -8,6 +8,8 @@
 #include <DirectXMath.h>
 #include <vector>
 #include <concepts>
+#include <array>
+#include "Utilities/Parallel.h"
 
 
 // Namespace Case_Engine
@@ -24,66 +26,91 @@ namespace Case_Engine
     {
         using namespace DirectX;
 
-        template<typename vertex_t, typename index_t> requires HasPositionAndNormal<vertex_t>&& std::integral<index_t>
-            void ComputeNormalsEqualWeight(
-                std::vector<vertex_t>& vertices,
-                std::vector<index_t> const& indices,
-                bool cw = false
-        )
-        {
-            std::vector<XMVECTOR> normals(vertices.size());
-
-           
-            for (size_t face = 0; face < indices.size() / 3; ++face)
-            {
-                index_t i0 = indices[face * 3];
-                index_t i1 = indices[face * 3 + 1];
-                index_t i2 = indices[face * 3 + 2];
+        inline constexpr size_t FACE_BLOCK_SIZE = 16384;
 
-                if (i0 == index_t(-1)
-                    || i1 == index_t(-1)
-                    || i2 == index_t(-1))
-                    continue;
-
-                if (i0 >= vertices.size()
-                    || i1 >= vertices.size()
-                    || i2 >= vertices.size())
-                    break;
-
-                XMVECTOR p1 = XMLoadFloat3(&vertices[i0].position);
-                XMVECTOR p2 = XMLoadFloat3(&vertices[i1].position);
-                XMVECTOR p3 = XMLoadFloat3(&vertices[i2].position);
-
-                XMVECTOR u = XMVectorSubtract(p2, p1);
-                XMVECTOR v = XMVectorSubtract(p3, p1);
-
-                XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
+        //face normals are weighted in parallel one block at a time and then accumulated in face order;
+        //returns false at the first face with an out of range index, with the faces before it accumulated
+        template<typename vertex_t, typename index_t, typename F> requires HasPositionAndNormal<vertex_t>&& std::integral<index_t>
+        bool AccumulateFaceNormals(
+            std::vector<vertex_t> const& vertices,
+            std::vector<index_t> const& indices,
+            std::vector<XMVECTOR>& normals,
+            F const& weighted_face_normal)
+        {
+            size_t const face_count = indices.size() / 3;
+            std::vector<std::array<XMVECTOR, 3>> block((std::min)(FACE_BLOCK_SIZE, face_count));
 
-                normals[i0] = XMVectorAdd(normals[i0], faceNormal);
-                normals[i1] = XMVectorAdd(normals[i1], faceNormal);
-                normals[i2] = XMVectorAdd(normals[i2], faceNormal);
-            }
+            auto FaceIndices = [&](size_t face, index_t& i0, index_t& i1, index_t& i2)
+                {
+                    i0 = indices[face * 3];
+                    i1 = indices[face * 3 + 1];
+                    i2 = indices[face * 3 + 2];
+                    return i0 != index_t(-1) && i1 != index_t(-1) && i2 != index_t(-1);
+                };
 
-            // Store results
-            if (cw)
+            for (size_t block_first = 0; block_first < face_count; block_first += FACE_BLOCK_SIZE)
             {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
+                size_t const block_last = (std::min)(block_first + FACE_BLOCK_SIZE, face_count);
+                ParallelFor(block_first, block_last, 1024, [&](size_t face)
+                    {
+                        index_t i0, i1, i2;
+                        if (!FaceIndices(face, i0, i1, i2)) return;
+                        if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) return;
+
+                        XMVECTOR p0 = XMLoadFloat3(&vertices[i0].position);
+                        XMVECTOR p1 = XMLoadFloat3(&vertices[i1].position);
+                        XMVECTOR p2 = XMLoadFloat3(&vertices[i2].position);
+                        block[face - block_first] = weighted_face_normal(p0, p1, p2);
+                    });
+
+                for (size_t face = block_first; face < block_last; ++face)
                 {
-                    XMVECTOR n = XMVector3Normalize(normals[vert]);
-                    n = XMVectorNegate(n);
-                    XMStoreFloat3(&vertices[vert].normal, n);
+                    index_t i0, i1, i2;
+                    if (!FaceIndices(face, i0, i1, i2)) continue;
+                    if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) return false;
+
+                    auto const& weighted = block[face - block_first];
+                    normals[i0] = XMVectorAdd(normals[i0], weighted[0]);
+                    normals[i1] = XMVectorAdd(normals[i1], weighted[1]);
+                    normals[i2] = XMVectorAdd(normals[i2], weighted[2]);
                 }
             }
-            else
-            {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
+            return true;
+        }
+
+        template<typename vertex_t> requires HasPositionAndNormal<vertex_t>
+        void StoreNormals(
+            std::vector<vertex_t>& vertices,
+            std::vector<XMVECTOR> const& normals,
+            bool cw)
+        {
+            ParallelFor(0, vertices.size(), 4096, [&](size_t vert)
                 {
                     XMVECTOR n = XMVector3Normalize(normals[vert]);
+                    if (cw) n = XMVectorNegate(n);
                     XMStoreFloat3(&vertices[vert].normal, n);
-                }
-            }
+                });
+        }
+
+        template<typename vertex_t, typename index_t> requires HasPositionAndNormal<vertex_t>&& std::integral<index_t>
+            void ComputeNormalsEqualWeight(
+                std::vector<vertex_t>& vertices,
+                std::vector<index_t> const& indices,
+                bool cw = false
+        )
+        {
+            std::vector<XMVECTOR> normals(vertices.size());
+
+            AccumulateFaceNormals(vertices, indices, normals, [](FXMVECTOR p1, FXMVECTOR p2, FXMVECTOR p3)
+                {
+                    XMVECTOR u = XMVectorSubtract(p2, p1);
+                    XMVECTOR v = XMVectorSubtract(p3, p1);
 
+                    XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
+                    return std::array<XMVECTOR, 3>{ faceNormal, faceNormal, faceNormal };
+                });
 
+            StoreNormals(vertices, normals, cw);
         }
 
 
@@ -95,151 +122,77 @@ namespace Case_Engine
         {
             std::vector<XMVECTOR> normals(vertices.size());
 
-            for (size_t face = 0; face < indices.size() / 3; ++face)
-            {
-                index_t i0 = indices[face * 3];
-                index_t i1 = indices[face * 3 + 1];
-                index_t i2 = indices[face * 3 + 2];
-
-                if (i0 == index_t(-1)
-                    || i1 == index_t(-1)
-                    || i2 == index_t(-1))
-                    continue;
-
-                if (i0 >= vertices.size()
-                    || i1 >= vertices.size()
-                    || i2 >= vertices.size())
-                    return;
-
-                XMVECTOR p0 = XMLoadFloat3(&vertices[i0].position);
-                XMVECTOR p1 = XMLoadFloat3(&vertices[i1].position);
-                XMVECTOR p2 = XMLoadFloat3(&vertices[i2].position);
-
-                XMVECTOR u = XMVectorSubtract(p1, p0);
-                XMVECTOR v = XMVectorSubtract(p2, p0);
-
-                XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
-
-                // Corner 0 -> 1 - 0, 2 - 0
-                XMVECTOR a = XMVector3Normalize(u);
-                XMVECTOR b = XMVector3Normalize(v);
-                XMVECTOR w0 = XMVector3Dot(a, b);
-                w0 = XMVectorClamp(w0, g_XMNegativeOne, g_XMOne);
-                w0 = XMVectorACos(w0);
-
-                // Corner 1 -> 2 - 1, 0 - 1
-                XMVECTOR c = XMVector3Normalize(XMVectorSubtract(p2, p1));
-                XMVECTOR d = XMVector3Normalize(XMVectorSubtract(p0, p1));
-                XMVECTOR w1 = XMVector3Dot(c, d);
-                w1 = XMVectorClamp(w1, g_XMNegativeOne, g_XMOne);
-                w1 = XMVectorACos(w1);
-
-                // Corner 2 -> 0 - 2, 1 - 2
-                XMVECTOR e = XMVector3Normalize(XMVectorSubtract(p0, p2));
-                XMVECTOR f = XMVector3Normalize(XMVectorSubtract(p1, p2));
-                XMVECTOR w2 = XMVector3Dot(e, f);
-                w2 = XMVectorClamp(w2, g_XMNegativeOne, g_XMOne);
-                w2 = XMVectorACos(w2);
-
-                normals[i0] = XMVectorMultiplyAdd(faceNormal, w0, normals[i0]);
-                normals[i1] = XMVectorMultiplyAdd(faceNormal, w1, normals[i1]);
-                normals[i2] = XMVectorMultiplyAdd(faceNormal, w2, normals[i2]);
-            }
-
-            // Store results
-            if (cw)
-            {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
+            bool const valid = AccumulateFaceNormals(vertices, indices, normals, [](FXMVECTOR p0, FXMVECTOR p1, FXMVECTOR p2)
                 {
-                    XMVECTOR n = XMVector3Normalize(normals[vert]);
-                    n = XMVectorNegate(n);
-                    XMStoreFloat3(&vertices[vert].normal, n);
-                }
-            }
-            else
-            {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
-                {
-                    XMVECTOR n = XMVector3Normalize(normals[vert]);
-                    XMStoreFloat3(&vertices[vert].normal, n);
-                }
-            }
-
-
+                    XMVECTOR u = XMVectorSubtract(p1, p0);
+                    XMVECTOR v = XMVectorSubtract(p2, p0);
+
+                    XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
+
+                    // Corner 0 -> 1 - 0, 2 - 0
+                    XMVECTOR a = XMVector3Normalize(u);
+                    XMVECTOR b = XMVector3Normalize(v);
+                    XMVECTOR w0 = XMVector3Dot(a, b);
+                    w0 = XMVectorClamp(w0, g_XMNegativeOne, g_XMOne);
+                    w0 = XMVectorACos(w0);
+
+                    // Corner 1 -> 2 - 1, 0 - 1
+                    XMVECTOR c = XMVector3Normalize(XMVectorSubtract(p2, p1));
+                    XMVECTOR d = XMVector3Normalize(XMVectorSubtract(p0, p1));
+                    XMVECTOR w1 = XMVector3Dot(c, d);
+                    w1 = XMVectorClamp(w1, g_XMNegativeOne, g_XMOne);
+                    w1 = XMVectorACos(w1);
+
+                    // Corner 2 -> 0 - 2, 1 - 2
+                    XMVECTOR e = XMVector3Normalize(XMVectorSubtract(p0, p2));
+                    XMVECTOR f = XMVector3Normalize(XMVectorSubtract(p1, p2));
+                    XMVECTOR w2 = XMVector3Dot(e, f);
+                    w2 = XMVectorClamp(w2, g_XMNegativeOne, g_XMOne);
+                    w2 = XMVectorACos(w2);
+
+                    return std::array<XMVECTOR, 3>{ XMVectorMultiply(faceNormal, w0), XMVectorMultiply(faceNormal, w1), XMVectorMultiply(faceNormal, w2) };
+                });
+            if (!valid) return;
+
+            StoreNormals(vertices, normals, cw);
         }
 
         template<typename vertex_t, typename index_t> requires HasPositionAndNormal<vertex_t>&& std::integral<index_t>
         void ComputeNormalsWeightedByArea(
             std::vector<vertex_t>& vertices,
-            std::vector<index_t> indices,
+            std::vector<index_t> const& indices,
             bool cw = false) 
         {
             std::vector<XMVECTOR> normals(vertices.size());
 
-            for (size_t face = 0; face < indices.size() / 3; ++face)
-            {
-                index_t i0 = indices[face * 3];
-                index_t i1 = indices[face * 3 + 1];
-                index_t i2 = indices[face * 3 + 2];
-
-                if (i0 == index_t(-1)
-                    || i1 == index_t(-1)
-                    || i2 == index_t(-1))
-                    continue;
-
-                if (i0 >= vertices.size()
-                    || i1 >= vertices.size()
-                    || i2 >= vertices.size())
-                    return;
-
-                XMVECTOR p0 = XMLoadFloat3(&vertices[i0].position);
-                XMVECTOR p1 = XMLoadFloat3(&vertices[i1].position);
-                XMVECTOR p2 = XMLoadFloat3(&vertices[i2].position);
-
-                XMVECTOR u = XMVectorSubtract(p1, p0);
-                XMVECTOR v = XMVectorSubtract(p2, p0);
-
-                XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
-
-                // Corner 0 -> 1 - 0, 2 - 0
-                XMVECTOR w0 = XMVector3Cross(u, v);
-                w0 = XMVector3Length(w0);
-
-                // Corner 1 -> 2 - 1, 0 - 1
-                XMVECTOR c = XMVectorSubtract(p2, p1);
-                XMVECTOR d = XMVectorSubtract(p0, p1);
-                XMVECTOR w1 = XMVector3Cross(c, d);
-                w1 = XMVector3Length(w1);
-
-                // Corner 2 -> 0 - 2, 1 - 2
-                XMVECTOR e = XMVectorSubtract(p0, p2);
-                XMVECTOR f = XMVectorSubtract(p1, p2);
-                XMVECTOR w2 = XMVector3Cross(e, f);
-                w2 = XMVector3Length(w2);
-
-                normals[i0] = XMVectorMultiplyAdd(faceNormal, w0, normals[i0]);
-                normals[i1] = XMVectorMultiplyAdd(faceNormal, w1, normals[i1]);
-                normals[i2] = XMVectorMultiplyAdd(faceNormal, w2, normals[i2]);
-            }
-
-            // Store results
-            if (cw)
-            {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
-                {
-                    XMVECTOR n = XMVector3Normalize(normals[vert]);
-                    n = XMVectorNegate(n);
-                    XMStoreFloat3(&vertices[vert].normal, n);
-                }
-            }
-            else
-            {
-                for (size_t vert = 0; vert < vertices.size(); ++vert)
+            bool const valid = AccumulateFaceNormals(vertices, indices, normals, [](FXMVECTOR p0, FXMVECTOR p1, FXMVECTOR p2)
                 {
-                    XMVECTOR n = XMVector3Normalize(normals[vert]);
-                    XMStoreFloat3(&vertices[vert].normal, n);
-                }
-            }
+                    XMVECTOR u = XMVectorSubtract(p1, p0);
+                    XMVECTOR v = XMVectorSubtract(p2, p0);
+
+                    XMVECTOR faceNormal = XMVector3Normalize(XMVector3Cross(u, v));
+
+                    // Corner 0 -> 1 - 0, 2 - 0
+                    XMVECTOR w0 = XMVector3Cross(u, v);
+                    w0 = XMVector3Length(w0);
+
+                    // Corner 1 -> 2 - 1, 0 - 1
+                    XMVECTOR c = XMVectorSubtract(p2, p1);
+                    XMVECTOR d = XMVectorSubtract(p0, p1);
+                    XMVECTOR w1 = XMVector3Cross(c, d);
+                    w1 = XMVector3Length(w1);
+
+                    // Corner 2 -> 0 - 2, 1 - 2
+                    XMVECTOR e = XMVectorSubtract(p0, p2);
+                    XMVECTOR f = XMVectorSubtract(p1, p2);
+                    XMVECTOR w2 = XMVector3Cross(e, f);
+                    w2 = XMVector3Length(w2);
+
+                    return std::array<XMVECTOR, 3>{ XMVectorMultiply(faceNormal, w0), XMVectorMultiply(faceNormal, w1), XMVectorMultiply(faceNormal, w2) };
+                });
+            if (!valid) return;
+
+            StoreNormals(vertices, normals, cw);
         }
     }
 
@@ -255,7 +208,7 @@ namespace Case_Engine
     void ComputeNormals(
         ENormalCalculation normal_type,
         std::vector<vertex_t>& vertices,
-        std::vector<index_t> indices,
+        std::vector<index_t> const& indices,
         bool cw = false)
     {
         switch (normal_type)
@@ -6,6 +6,7 @@
 // Includes
 #pragma once
 #include <memory>
+#include <tuple>
 #include "Enums.h"
 #include "Terrain.h"
 #include "TextureManager.h"
@@ -13,7 +14,9 @@
 #include "Graphics/GfxVertexFormat.h"
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxStates.h"
+#include "Utilities/NameTable.h"
 #include "tecs/entity.h"
+#include "tecs/component_traits.h"
 
 #define COMPONENT 
 
@@ -27,14 +30,18 @@ namespace Case_Engine
 	{
 		Matrix starting_transform = Matrix::Identity;
 		Matrix current_transform = Matrix::Identity;
+
+		//cached by UpdateWorldTransforms, current_transform combined with the parent's world
+		Matrix world = Matrix::Identity;
+		Matrix inverse_world = Matrix::Identity;
 	};
 
 	struct COMPONENT Relationship
 	{
-		static constexpr size_t MAX_CHILDREN = 2048;
 		tecs::entity parent = tecs::null_entity;
-		uint32_t children_count = 0;
-		tecs::entity children[MAX_CHILDREN] = { tecs::null_entity };
+		tecs::entity first_child = tecs::null_entity;
+		tecs::entity next_sibling = tecs::null_entity;
+		uint32_t depth = 0;
 	};
 
 	struct COMPONENT Mesh
@@ -109,6 +116,14 @@ namespace Case_Engine
 		float godrays_exposure = 2.0f;
 	};
 
+	enum AABBFlags : uint8_t
+	{
+		AABBFlag_None = 0x0,
+		AABBFlag_CameraVisible = 0x1,
+		AABBFlag_LightVisible = 0x2,
+		AABBFlag_SkipCulling = 0x4
+	};
+
 	struct COMPONENT AABB
 	{
 		BoundingBox bounding_box;
@@ -206,6 +221,49 @@ namespace Case_Engine
 
 	struct COMPONENT Tag
 	{
-		std::string name = "default";
+		NameId name = DEFAULT_NAME_ID;
+	};
+}
+
+namespace Case_Engine::tecs
+{
+	template<>
+	struct component_traits<Relationship>
+	{
+		static constexpr storage_policy storage = storage_policy::dense;
+
+		template<typename F>
+		static void remap(Relationship& relationship, F const& map)
+		{
+			relationship.parent = map(relationship.parent);
+			relationship.first_child = map(relationship.first_child);
+			relationship.next_sibling = map(relationship.next_sibling);
+		}
+	};
+
+	template<>
+	struct component_traits<Mesh>
+	{
+		static constexpr storage_policy storage = storage_policy::paged;
+		static constexpr size_t page_size = 256;
+	};
+
+	template<>
+	struct component_traits<AABB>
+	{
+		static constexpr storage_policy storage = storage_policy::dense;
+
+		//center xyz, extents xyz, AABBFlags
+		using soa_streams = std::tuple<float, float, float, float, float, float, uint8_t>;
+
+		static soa_streams extract(AABB const& aabb)
+		{
+			auto const& box = aabb.bounding_box;
+			uint8_t flags = AABBFlag_None;
+			if (aabb.camera_visible) flags |= AABBFlag_CameraVisible;
+			if (aabb.light_visible) flags |= AABBFlag_LightVisible;
+			if (aabb.skip_culling) flags |= AABBFlag_SkipCulling;
+			return { box.Center.x, box.Center.y, box.Center.z, box.Extents.x, box.Extents.y, box.Extents.z, flags };
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <tuple>
+#include "Components.h"
+#include "tecs/snapshot.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+	template<>
+	struct snapshot_traits<Mesh>
+	{
+		static void save(snapshot_archive& archive, Mesh const* meshes, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				Mesh const& mesh = meshes[i];
+				archive.write(mesh.vertex_buffer);
+				archive.write(mesh.index_buffer);
+				archive.write(mesh.instance_buffer);
+				archive.write(mesh.vertex_count);
+				archive.write(mesh.start_vertex_location);
+				archive.write(mesh.indices_count);
+				archive.write(mesh.start_index_location);
+				archive.write(mesh.base_vertex_location);
+				archive.write(mesh.instance_count);
+				archive.write(mesh.start_instance_location);
+				archive.write(mesh.topology);
+			}
+		}
+
+		static void load(snapshot_archive& archive, Mesh* meshes, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				Mesh& mesh = meshes[i];
+				archive.read(mesh.vertex_buffer);
+				archive.read(mesh.index_buffer);
+				archive.read(mesh.instance_buffer);
+				archive.read(mesh.vertex_count);
+				archive.read(mesh.start_vertex_location);
+				archive.read(mesh.indices_count);
+				archive.read(mesh.start_index_location);
+				archive.read(mesh.base_vertex_location);
+				archive.read(mesh.instance_count);
+				archive.read(mesh.start_instance_location);
+				archive.read(mesh.topology);
+			}
+		}
+	};
+
+	template<>
+	struct snapshot_traits<AABB>
+	{
+		static void save(snapshot_archive& archive, AABB const* aabbs, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				AABB const& aabb = aabbs[i];
+				archive.write(aabb.bounding_box);
+				archive.write(aabb.camera_visible);
+				archive.write(aabb.light_visible);
+				archive.write(aabb.skip_culling);
+				archive.write(aabb.draw_aabb);
+				archive.write(aabb.aabb_vb);
+			}
+		}
+
+		static void load(snapshot_archive& archive, AABB* aabbs, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				AABB& aabb = aabbs[i];
+				archive.read(aabb.bounding_box);
+				archive.read(aabb.camera_visible);
+				archive.read(aabb.light_visible);
+				archive.read(aabb.skip_culling);
+				archive.read(aabb.draw_aabb);
+				archive.read(aabb.aabb_vb);
+			}
+		}
+	};
+}
+
+namespace Case_Engine
+{
+	using SnapshotComponents = std::tuple<Transform, Relationship, Mesh, Material, Light, AABB, RenderState, Skybox, 
+										  Ocean, Foliage, Deferred, TerrainComponent, Emitter, Decal, Forward, Tag>;
+
+	inline void SaveSceneSnapshot(tecs::registry const& reg, tecs::snapshot_archive& archive)
+	{
+		[&]<typename... Cs>(std::type_identity<std::tuple<Cs...>>) { tecs::snapshot::save<Cs...>(reg, archive); }(std::type_identity<SnapshotComponents>{});
+	}
+
+	inline void LoadSceneSnapshot(tecs::registry& reg, tecs::snapshot_archive& archive)
+	{
+		[&]<typename... Cs>(std::type_identity<std::tuple<Cs...>>) { tecs::snapshot::load<Cs...>(reg, archive); }(std::type_identity<SnapshotComponents>{});
+	}
+}
\ No newline at end of file
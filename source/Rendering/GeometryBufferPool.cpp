@@ -0,0 +1,113 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#include <mutex>
+#include "GeometryBufferPool.h"
+#include "Graphics/GfxBuffer.h"
+#include "Utilities/Task.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace impl
+	{
+		struct GeometryPage
+		{
+			GeometryPage(GfxDevice* gfx, GfxBufferDesc const& desc) 
+				: buffer(gfx, desc), allocator(desc.size / desc.stride)
+			{}
+
+			bool Matches(GfxBufferDesc const& desc) const
+			{
+				GfxBufferDesc const& page_desc = buffer.GetDesc();
+				return page_desc.bind_flags == desc.bind_flags && page_desc.stride == desc.stride && page_desc.format == desc.format;
+			}
+
+			GfxBuffer buffer;
+			OffsetAllocator allocator;
+			mutable std::mutex mutex;
+		};
+	}
+
+	GeometryBufferPool::GeometryBufferPool(GfxDevice* gfx) : gfx(gfx) {}
+
+	GeometryBufferPool::~GeometryBufferPool() = default;
+
+	GeometryRange GeometryBufferPool::AllocateVertices(void const* data, uint32_t vertex_count, uint32_t stride)
+	{
+		return Allocate(data, vertex_count, stride, false);
+	}
+
+	GeometryRange GeometryBufferPool::AllocateIndices(void const* data, uint32_t index_count, bool small_indices)
+	{
+		return Allocate(data, index_count, small_indices ? 2 : 4, true);
+	}
+
+	OffsetAllocatorStats GeometryBufferPool::Stats() const
+	{
+		OffsetAllocatorStats stats{};
+		for (auto const& page : pages)
+		{
+			std::lock_guard lock(page->mutex);
+			OffsetAllocatorStats const page_stats = page->allocator.Stats();
+			uint32_t const stride = page->buffer.GetDesc().stride;
+			stats.used_size += page_stats.used_size * stride;
+			stats.free_size += page_stats.free_size * stride;
+			stats.largest_free_region = std::max(stats.largest_free_region, page_stats.largest_free_region * stride);
+			stats.allocation_count += page_stats.allocation_count;
+			stats.free_region_count += page_stats.free_region_count;
+		}
+		return stats;
+	}
+
+	GeometryRange GeometryBufferPool::Allocate(void const* data, uint32_t count, uint32_t stride, bool index_buffer)
+	{
+		CASE_ENGINE_ASSERT(g_TaskScheduler.IsMainThread());
+		if (count == 0) return {};
+
+		GfxBufferDesc desc = index_buffer ? IndexBufferDesc(count, stride == 2) : VertexBufferDesc(count, stride);
+		uint64_t const page_size = index_buffer ? INDEX_PAGE_SIZE : VERTEX_PAGE_SIZE;
+		//big meshes (terrain, ocean) would eat most of a page, they keep a buffer of their own
+		if (desc.size > page_size / 4) return GeometryRange{ .buffer = std::make_shared<GfxBuffer>(gfx, desc, data) };
+
+		std::shared_ptr<impl::GeometryPage> page = nullptr;
+		OffsetAllocation allocation{};
+		for (auto const& candidate : pages)
+		{
+			if (!candidate->Matches(desc)) continue;
+			std::lock_guard lock(candidate->mutex);
+			allocation = candidate->allocator.Allocate(count);
+			if (allocation.Valid())
+			{
+				page = candidate;
+				break;
+			}
+		}
+		if (!page)
+		{
+			GfxBufferDesc page_desc = desc;
+			page_desc.resource_usage = GfxResourceUsage::Default;
+			page_desc.size = page_size - page_size % stride;
+			page = pages.emplace_back(std::make_shared<impl::GeometryPage>(gfx, page_desc));
+			allocation = page->allocator.Allocate(count);
+		}
+		CASE_ENGINE_ASSERT(allocation.Valid());
+
+		uint32_t const first = static_cast<uint32_t>(allocation.offset);
+		D3D11_BOX box{ .left = first * stride, .top = 0, .front = 0, .right = (first + count) * stride, .bottom = 1, .back = 1 };
+		gfx->GetContext()->UpdateSubresource(page->buffer.GetNative(), 0, &box, data, 0, 0);
+
+		//the deleter keeps the page alive and hands the range back instead of destroying the shared buffer
+		std::shared_ptr<GfxBuffer> buffer(&page->buffer, [page, allocation](GfxBuffer*)
+			{
+				std::lock_guard lock(page->mutex);
+				page->allocator.Free(allocation);
+			});
+		return GeometryRange{ .buffer = std::move(buffer), .first = first };
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <memory>
+#include <vector>
+#include <concepts>
+#include "Utilities/OffsetAllocator.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	class GfxDevice;
+	class GfxBuffer;
+	namespace impl
+	{
+		struct GeometryPage;
+	}
+
+	struct GeometryRange
+	{
+		//shares one of the pool's buffers, the range goes back to its page once the last copy is released
+		std::shared_ptr<GfxBuffer> buffer = nullptr;
+		uint32_t first = 0; //first vertex or index of the range inside buffer
+	};
+
+	//vertex and index data of all meshes is packed into a few big buffers per vertex stride / index format,
+	//meshes address their range through base_vertex_location, start_index_location and start_vertex_location
+	class GeometryBufferPool
+	{
+	public:
+		static constexpr uint64_t VERTEX_PAGE_SIZE = 64ull << 20;
+		static constexpr uint64_t INDEX_PAGE_SIZE = 32ull << 20;
+
+	public:
+		explicit GeometryBufferPool(GfxDevice* gfx);
+		GeometryBufferPool(GeometryBufferPool const&) = delete;
+		GeometryBufferPool& operator=(GeometryBufferPool const&) = delete;
+		~GeometryBufferPool();
+
+		//main thread only, the data is uploaded through the immediate context
+		GeometryRange AllocateVertices(void const* data, uint32_t vertex_count, uint32_t stride);
+		GeometryRange AllocateIndices(void const* data, uint32_t index_count, bool small_indices);
+
+		template<typename V>
+		GeometryRange AllocateVertices(std::vector<V> const& vertices)
+		{
+			return AllocateVertices(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(V));
+		}
+		template<typename I> requires std::same_as<I, uint16_t> || std::same_as<I, uint32_t>
+		GeometryRange AllocateIndices(std::vector<I> const& indices)
+		{
+			return AllocateIndices(indices.data(), static_cast<uint32_t>(indices.size()), sizeof(I) == 2);
+		}
+
+		//summed over all pages, largest_free_region is the largest of any page
+		OffsetAllocatorStats Stats() const;
+		uint64_t PageCount() const { return pages.size(); }
+
+	private:
+		GfxDevice* gfx;
+		std::vector<std::shared_ptr<impl::GeometryPage>> pages;
+
+	private:
+		GeometryRange Allocate(void const* data, uint32_t count, uint32_t stride, bool index_buffer);
+	};
+}
\ No newline at end of file
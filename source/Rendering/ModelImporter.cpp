@@ -16,7 +16,9 @@
 
 #include "ModelImporter.h"
 #include "TextureManager.h"
+#include "SceneGraph.h"
 #include "Core/Logger.h"
+#include "Core/CpuProfiler.h"
 #include "tecs/registry.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxVertexFormat.h"
@@ -28,6 +30,7 @@
 #include "Utilities/Image.h"
 #include "Utilities/HashMap.h"
 #include "Utilities/StringUtil.h"
+#include "Utilities/Parallel.h"
 
 
 // Using DirectX
@@ -39,6 +42,8 @@ namespace Case_Engine
 {
     namespace
     {
+		constexpr size_t ATTRIBUTE_GRAIN = 4096;
+
 		void GenerateTerrainLayerTexture(char const* texture_name, Terrain* terrain, TerrainTextureLayerParameters const& params)
 		{
 			auto [width, depth] = terrain->TileCounts();
@@ -46,82 +51,117 @@ namespace Case_Engine
 
 			std::vector<BYTE> temp_layer_data(width * depth * 4);
 			std::vector<BYTE> layer_data(width * depth * 4);
-			for (uint64_t j = 0; j < depth; ++j)
-			{
-				for (uint64_t i = 0; i < width; ++i)
+			ParallelFor(0, depth, 16, [&](size_t j)
 				{
-					float x = i * tile_size_x;
-					float z = j * tile_size_z;
+					for (uint64_t i = 0; i < width; ++i)
+					{
+						float x = i * tile_size_x;
+						float z = j * tile_size_z;
 
-					float height = terrain->HeightAt(x, z);
-					float normal_y = terrain->NormalAt(x, z).y;
+						float height = terrain->HeightAt(x, z);
+						float normal_y = terrain->NormalAt(x, z).y;
 
-					if (height > params.terrain_rocks_start)
-					{
-						float mix_multiplier = std::max(
-							(height - params.terrain_rocks_start) / params.height_mix_zone,
-							1.0f
-						);
-						float rock_slope_multiplier = std::clamp((normal_y - params.terrain_slope_rocks_start) / params.slope_mix_zone, 0.0f, 1.0f);
-						temp_layer_data[(j * width + i) * 4 + 0] = (BYTE) (BYTE_MAX * mix_multiplier * rock_slope_multiplier);
-					}
+						if (height > params.terrain_rocks_start)
+						{
+							float mix_multiplier = std::max(
+								(height - params.terrain_rocks_start) / params.height_mix_zone,
+								1.0f
+							);
+							float rock_slope_multiplier = std::clamp((normal_y - params.terrain_slope_rocks_start) / params.slope_mix_zone, 0.0f, 1.0f);
+							temp_layer_data[(j * width + i) * 4 + 0] = (BYTE) (BYTE_MAX * mix_multiplier * rock_slope_multiplier);
+						}
 
-					if (height > params.terrain_sand_start && height <= params.terrain_sand_end)
-					{
-                        float mix_multiplier = std::min(
-                            (height-params.terrain_sand_start) / params.height_mix_zone,
-                            (params.terrain_sand_end - height) / params.height_mix_zone
-						);
-						temp_layer_data[(j * width + i) * 4 + 1] = (BYTE) (BYTE_MAX * mix_multiplier);
-					}
+						if (height > params.terrain_sand_start && height <= params.terrain_sand_end)
+						{
+                            float mix_multiplier = std::min(
+                                (height-params.terrain_sand_start) / params.height_mix_zone,
+                                (params.terrain_sand_end - height) / params.height_mix_zone
+							);
+							temp_layer_data[(j * width + i) * 4 + 1] = (BYTE) (BYTE_MAX * mix_multiplier);
+						}
 
-					if (height > params.terrain_grass_start && height <= params.terrain_grass_end)
-					{
-						float mix_multiplier = std::min(
-							(height - params.terrain_grass_start) / params.height_mix_zone,
-							(params.terrain_grass_end - height) / params.height_mix_zone
-						);
+						if (height > params.terrain_grass_start && height <= params.terrain_grass_end)
+						{
+							float mix_multiplier = std::min(
+								(height - params.terrain_grass_start) / params.height_mix_zone,
+								(params.terrain_grass_end - height) / params.height_mix_zone
+							);
 
-						float grass_slope_multiplier = std::clamp((normal_y - params.terrain_slope_grass_start) / params.slope_mix_zone, 0.0f, 1.0f);
-                        temp_layer_data[(j * width + i) * 4 + 2] = (BYTE)(BYTE_MAX * mix_multiplier * grass_slope_multiplier);
-					}
+							float grass_slope_multiplier = std::clamp((normal_y - params.terrain_slope_grass_start) / params.slope_mix_zone, 0.0f, 1.0f);
+                            temp_layer_data[(j * width + i) * 4 + 2] = (BYTE)(BYTE_MAX * mix_multiplier * grass_slope_multiplier);
+						}
 
-					uint32_t sum = temp_layer_data[(j * width + i) * 4 + 0]
-						+ temp_layer_data[(j * width + i) * 4 + 1] + temp_layer_data[(j * width + i) * 4 + 2] + 1;
+						uint32_t sum = temp_layer_data[(j * width + i) * 4 + 0]
+							+ temp_layer_data[(j * width + i) * 4 + 1] + temp_layer_data[(j * width + i) * 4 + 2] + 1;
 
-					temp_layer_data[(j * width + i) * 4 + 0] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 0] * 1.0f / sum) * BYTE_MAX);
-					temp_layer_data[(j * width + i) * 4 + 1] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 1] * 1.0f / sum) * BYTE_MAX);
-					temp_layer_data[(j * width + i) * 4 + 2] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 2] * 1.0f / sum) * BYTE_MAX);
-				}
-			}
+						temp_layer_data[(j * width + i) * 4 + 0] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 0] * 1.0f / sum) * BYTE_MAX);
+						temp_layer_data[(j * width + i) * 4 + 1] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 1] * 1.0f / sum) * BYTE_MAX);
+						temp_layer_data[(j * width + i) * 4 + 2] = (BYTE)((temp_layer_data[(j * width + i) * 4 + 2] * 1.0f / sum) * BYTE_MAX);
+					}
+				});
 
 			layer_data = temp_layer_data;
 
-			for (size_t j = 2; j < depth - 2; ++j)
-			{
-				for (size_t i = 2; i < width - 2; ++i)
+			ParallelFor(2, depth - 2, 16, [&](size_t j)
 				{
-					int32_t n1 = 0, n2 = 0, n3 = 0, n4 = 0;
-					for (int32_t k = -2; k <= 2; ++k)
+					for (size_t i = 2; i < width - 2; ++i)
 					{
-						for (int32_t l = -2; l <= 2; ++l)
+						int32_t n1 = 0, n2 = 0, n3 = 0, n4 = 0;
+						for (int32_t k = -2; k <= 2; ++k)
 						{
-							n1 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 0];
-							n2 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 1];
-							n3 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 2];
+							for (int32_t l = -2; l <= 2; ++l)
+							{
+								n1 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 0];
+								n2 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 1];
+								n3 += (int32_t)temp_layer_data[((j + k) * width + i + l) * 4 + 2];
+							}
 						}
-					}
             
-					layer_data[(j * width + i) * 4 + 0] = (BYTE)(n1 / 25);
-					layer_data[(j * width + i) * 4 + 1] = (BYTE)(n2 / 25);
-					layer_data[(j * width + i) * 4 + 2] = (BYTE)(n3 / 25);
-				}
-			}
+						layer_data[(j * width + i) * 4 + 0] = (BYTE)(n1 / 25);
+						layer_data[(j * width + i) * 4 + 1] = (BYTE)(n2 / 25);
+						layer_data[(j * width + i) * 4 + 2] = (BYTE)(n3 / 25);
+					}
+				});
 
 			WriteImageTGA(texture_name, layer_data, (int32_t)width, (int32_t)depth);
 		}
     }
 
+	struct ParsedModel_GLTF
+	{
+		tinygltf::Model model;
+	};
+
+	namespace
+	{
+		//decodes the gltf json and loads its buffers, safe to call from any thread
+		std::optional<ParsedModel_GLTF> ParseModel_GLTF(std::string const& model_path, std::vector<uint8_t> const& data)
+		{
+			CaseEngineCpuProfileScope("Parse GLTF");
+			tinygltf::TinyGLTF loader;
+			ParsedModel_GLTF parsed{};
+			std::string err;
+			std::string warn;
+			bool ret = loader.LoadASCIIFromString(&parsed.model, &err, &warn, reinterpret_cast<char const*>(data.data()), static_cast<uint32_t>(data.size()), GetParentPath(model_path));
+
+			if (!warn.empty())
+			{
+				CASE_ENGINE_LOG(WARNING, warn.c_str());
+			}
+			if (!err.empty())
+			{
+				CASE_ENGINE_LOG(ERROR, err.c_str());
+				return std::nullopt;
+			}
+			if (!ret)
+			{
+				CASE_ENGINE_LOG(ERROR, "Failed to load model %s", GetFilename(model_path).c_str());
+				return std::nullopt;
+			}
+			return parsed;
+		}
+	}
+
     using namespace tecs;
 
     std::vector<entity> ModelImporter::LoadGrid(GridParameters const& params, std::vector<TexturedNormalVertex>* vertices_out)
@@ -133,22 +173,21 @@ namespace Case_Engine
         }
 
         std::vector<entity> chunks;
-        std::vector<TexturedNormalVertex> vertices{};
-        for (uint64_t j = 0; j <= params.tile_count_z; j++)
-        {
-            for (uint64_t i = 0; i <= params.tile_count_x; i++)
+        std::vector<TexturedNormalVertex> vertices((params.tile_count_z + 1) * (params.tile_count_x + 1));
+        ParallelFor(0, params.tile_count_z + 1, 16, [&](size_t j)
             {
-                TexturedNormalVertex vertex{};
+                for (uint64_t i = 0; i <= params.tile_count_x; i++)
+                {
+                    TexturedNormalVertex& vertex = vertices[j * (params.tile_count_x + 1) + i];
 
-                float height = params.heightmap ? params.heightmap->HeightAt(i, j) : 0.0f;
+                    float height = params.heightmap ? params.heightmap->HeightAt(i, j) : 0.0f;
 
-                vertex.position = Vector3(i * params.tile_size_x + params.grid_offset.x, 
-                    height + params.grid_offset.y, j * params.tile_size_z + params.grid_offset.z);
-                vertex.uv = Vector2(i * 1.0f * params.texture_scale_x / (params.tile_count_x - 1), j * 1.0f * params.texture_scale_z / (params.tile_count_z - 1));
-                vertex.normal = Vector3(0.0f, 1.0f, 0.0f);
-                vertices.push_back(vertex);
-            }
-        }
+                    vertex.position = Vector3(i * params.tile_size_x + params.grid_offset.x, 
+                        height + params.grid_offset.y, j * params.tile_size_z + params.grid_offset.z);
+                    vertex.uv = Vector2(i * 1.0f * params.texture_scale_x / (params.tile_count_x - 1), j * 1.0f * params.texture_scale_z / (params.tile_count_z - 1));
+                    vertex.normal = Vector3(0.0f, 1.0f, 0.0f);
+                }
+            });
 
         if (!params.split_to_chunks)
         {
@@ -184,10 +223,14 @@ namespace Case_Engine
             ComputeNormals(params.normal_type, vertices, indices);
 
             entity grid = reg.create();
+            GeometryRange vb = geometry_pool.AllocateVertices(vertices);
+            GeometryRange ib = geometry_pool.AllocateIndices(indices);
             Mesh mesh{};
-			mesh.vertex_buffer = std::make_shared<GfxBuffer>(gfx, VertexBufferDesc(vertices.size(), sizeof(TexturedNormalVertex)), vertices.data());
-			mesh.index_buffer = std::make_shared<GfxBuffer>(gfx, IndexBufferDesc(indices.size(), false), indices.data());
+			mesh.vertex_buffer = vb.buffer;
+			mesh.index_buffer = ib.buffer;
             mesh.indices_count = (uint32_t)indices.size();
+            mesh.start_index_location = ib.first;
+            mesh.base_vertex_location = static_cast<int32_t>(vb.first);
  
             reg.emplace<Mesh>(grid, mesh);
             reg.emplace<Transform>(grid);
@@ -204,11 +247,12 @@ namespace Case_Engine
         else
         {
             std::vector<uint32_t> indices{};
+            std::vector<Mesh> chunk_meshes{};
+            std::vector<AABB> chunk_aabbs{};
             for (size_t j = 0; j < params.tile_count_z; j += params.chunk_count_z)
             {
                 for (size_t i = 0; i < params.tile_count_x; i += params.chunk_count_x)
                 {
-                    entity chunk = reg.create();
                     uint32_t const indices_count = static_cast<uint32_t>(params.chunk_count_z * params.chunk_count_x * 3 * 2);
                     uint32_t const indices_offset = static_cast<uint32_t>(indices.size());
                     std::vector<TexturedNormalVertex> chunk_vertices_aabb{};
@@ -235,33 +279,34 @@ namespace Case_Engine
                             chunk_vertices_aabb.push_back(vertices[i4]);
                         }
                     }
-                    Mesh mesh{};
+                    Mesh& mesh = chunk_meshes.emplace_back();
                     mesh.indices_count = indices_count;
                     mesh.start_index_location = indices_offset;
-
-                    reg.emplace<Mesh>(chunk, mesh);
-                    reg.emplace<Transform>(chunk);
                     
 					BoundingBox bounding_box = AABBFromRange(chunk_vertices_aabb.begin(), chunk_vertices_aabb.end());
-					AABB aabb{};
+					AABB& aabb = chunk_aabbs.emplace_back();
 					aabb.bounding_box = bounding_box;
 					aabb.light_visible = true;
 					aabb.camera_visible = true;
 					aabb.UpdateBuffer(gfx);
-					reg.add<AABB>(chunk, aabb);
-					chunks.push_back(chunk);
                 }
             }
             ComputeNormals(params.normal_type, vertices, indices);
-			std::shared_ptr<GfxBuffer> vb = std::make_shared<GfxBuffer>(gfx, VertexBufferDesc(vertices.size(), sizeof(TexturedNormalVertex)), vertices.data());
-			std::shared_ptr<GfxBuffer> ib = std::make_shared<GfxBuffer>(gfx, IndexBufferDesc(indices.size(), false), indices.data());
-            for (entity chunk : chunks)
+            GeometryRange vb = geometry_pool.AllocateVertices(vertices);
+            GeometryRange ib = geometry_pool.AllocateIndices(indices);
+            for (auto& mesh : chunk_meshes)
             {
-                auto& mesh = reg.get<Mesh>(chunk);
-
-                mesh.vertex_buffer = vb;
-                mesh.index_buffer = ib;
+                mesh.vertex_buffer = vb.buffer;
+                mesh.index_buffer = ib.buffer;
+                mesh.start_index_location += ib.first;
+                mesh.base_vertex_location = static_cast<int32_t>(vb.first);
             }
+
+            chunks.reserve(chunk_meshes.size());
+            reg.create(chunk_meshes.size(), std::back_inserter(chunks));
+            reg.insert<Mesh>(chunks.begin(), chunks.end(), chunk_meshes.begin());
+            reg.insert<Transform>(chunks.begin(), chunks.end());
+            reg.insert<AABB>(chunks.begin(), chunks.end(), chunk_aabbs.begin());
         }
 
         if (vertices_out) *vertices_out = vertices;
@@ -289,12 +334,15 @@ namespace Case_Engine
         std::vector<tinyobj::material_t> const& materials = reader.GetMaterials();
 		std::vector<entity> entities{};
         std::vector<std::string> diffuse_textures;
+		entities.reserve(shapes.size());
+		reg.create(shapes.size(), std::back_inserter(entities));
+		reg.reserve<Mesh>(reg.size<Mesh>() + shapes.size());
+		reg.reserve<Tag>(reg.size<Tag>() + shapes.size());
 		for (size_t s = 0; s < shapes.size(); s++)
 		{
             std::vector<TexturedNormalVertex> vertices{};
 
-			entity e = reg.create();
-			entities.push_back(e);
+			entity e = entities[s];
 
 			size_t index_offset = 0;
 			for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++)
@@ -343,15 +391,15 @@ namespace Case_Engine
                 index_offset += fv;
 			}
 
-			std::shared_ptr<GfxBuffer> vb = std::make_shared<GfxBuffer>(gfx, VertexBufferDesc(vertices.size(), sizeof(TexturedNormalVertex)), vertices.data());
+			GeometryRange vb = geometry_pool.AllocateVertices(vertices);
 
 			Mesh mesh_component{};
-			mesh_component.base_vertex_location = 0;
+			mesh_component.start_vertex_location = vb.first;
 			mesh_component.vertex_count = static_cast<uint32_t>(vertices.size());
-            mesh_component.vertex_buffer = vb;
+            mesh_component.vertex_buffer = vb.buffer;
 			reg.emplace<Mesh>(e, mesh_component);
 
-			reg.emplace<Tag>(e, model_name + " mesh" + std::to_string(as_integer(e)));
+			reg.emplace<Tag>(e, g_NameTable.Generate(model_name + " mesh", as_integer(e)));
 
 			if (diffuse_textures_out)
 			{
@@ -367,36 +415,61 @@ namespace Case_Engine
 		return entities;
 	}
 
-	ModelImporter::ModelImporter(registry& reg, GfxDevice* gfx) : reg(reg), gfx(gfx) {}
+	ModelImporter::ModelImporter(registry& reg, GfxDevice* gfx) : reg(reg), gfx(gfx), geometry_pool(gfx) {}
 
 	std::vector<entity> ModelImporter::ImportModel_GLTF(ModelParameters const& params)
 	{
-		tinygltf::TinyGLTF loader;
-		tinygltf::Model model;
-		std::string err;
-		std::string warn;
-		bool ret = loader.LoadASCIIFromFile(&model, &err, &warn, params.model_path);
-
-		std::string model_name = GetFilename(params.model_path);
-		if (!warn.empty())
+		if (auto it = model_prefabs.find(params.model_path + params.textures_path); it != model_prefabs.end())
 		{
-			CASE_ENGINE_LOG(WARNING, warn.c_str());
-		}
-		if (!err.empty())
-		{
-			CASE_ENGINE_LOG(ERROR, err.c_str());
-			return {};
+			std::vector<entity> created = InstantiateModelPrefab(it->second, std::span(&params.model_matrix, 1));
+			return std::vector<entity>(created.begin() + 1, created.end());
 		}
-		if (!ret)
+
+		std::optional<std::vector<uint8_t>> data = ReadFileBytes(params.model_path);
+		if (!data)
 		{
-			CASE_ENGINE_LOG(ERROR, "Failed to load model %s", model_name.c_str());
+			CASE_ENGINE_LOG(ERROR, "Failed to load model %s", GetFilename(params.model_path).c_str());
 			return {};
 		}
+		std::optional<ParsedModel_GLTF> parsed = ParseModel_GLTF(params.model_path, *data);
+		if (!parsed) return {};
+		return CreateModel_GLTF(params, *parsed);
+	}
+	Task<std::vector<entity>> ModelImporter::ImportModelAsync_GLTF(ModelParameters params)
+	{
+		if (model_prefabs.find(params.model_path + params.textures_path) != model_prefabs.end()) co_return ImportModel_GLTF(params);
+
+		std::optional<std::vector<uint8_t>> data = co_await ReadFileAsync(params.model_path);
+		std::optional<ParsedModel_GLTF> parsed = std::nullopt;
+		if (data) parsed = ParseModel_GLTF(params.model_path, *data);
+		else CASE_ENGINE_LOG(ERROR, "Failed to load model %s", GetFilename(params.model_path).c_str());
+
+		co_await ResumeOnMainThread();
+		if (!parsed) co_return std::vector<entity>{};
+		co_return CreateModel_GLTF(params, *parsed);
+	}
+	std::vector<entity> ModelImporter::CreateModel_GLTF(ModelParameters const& params, ParsedModel_GLTF& parsed)
+	{
+		CaseEngineCpuProfileScope("Create GLTF Entities");
+		tinygltf::Model& model = parsed.model;
+		std::string model_name = GetFilename(params.model_path);
 
 		std::vector<CompleteVertex> vertices{};
 		std::vector<uint32_t> indices{};
 		std::vector<entity> entities{};
 		HashMap<std::string, std::vector<entity>> mesh_name_to_entities_map;
+
+		size_t primitive_count = 0;
+		for (auto const& mesh : model.meshes) primitive_count += mesh.primitives.size();
+		entities.reserve(primitive_count);
+		reg.create(primitive_count, std::back_inserter(entities));
+		reg.reserve<Material>(reg.size<Material>() + primitive_count);
+		reg.reserve<Deferred>(reg.size<Deferred>() + primitive_count);
+		reg.reserve<Mesh>(reg.size<Mesh>() + primitive_count);
+		reg.reserve<AABB>(reg.size<AABB>() + primitive_count);
+		reg.reserve<Transform>(reg.size<Transform>() + primitive_count + 1);
+
+		size_t primitive_index = 0;
 		for (auto& mesh : model.meshes)
 		{
 			std::vector<entity>& mesh_entities = mesh_name_to_entities_map[mesh.name];
@@ -405,8 +478,7 @@ namespace Case_Engine
 				CASE_ENGINE_ASSERT(primitive.indices >= 0);
 				tinygltf::Accessor const& index_accessor = model.accessors[primitive.indices];
 
-				entity e = reg.create();
-				entities.push_back(e);
+				entity e = entities[primitive_index++];
 				mesh_entities.push_back(e);
 
 				Material material{};
@@ -496,7 +568,6 @@ namespace Case_Engine
 				tinygltf::Buffer const& buffer = model.buffers[bufferView.buffer];
 
 				int stride = accessor.ByteStride(bufferView);
-				uint32_t vertex_offset = mesh_component.base_vertex_location;
 				uint32_t index_count = mesh_component.indices_count;
 				uint32_t index_offset = mesh_component.start_index_location;
 				indices.reserve(indices.size() + index_count);
@@ -551,65 +622,68 @@ namespace Case_Engine
 
 					if (!attr_name.compare("POSITION"))
 					{
-						positions.reserve(vertex_count);
-						for (size_t i = 0; i < vertex_count; ++i)
-						{
-							positions.push_back(*(Vector3*)((size_t)data + i * stride));
-						}
+						positions.resize(vertex_count);
+						ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+							{
+								positions[i] = *(Vector3*)((size_t)data + i * stride);
+							});
 					}
 					else if (!attr_name.compare("NORMAL"))
 					{
-						normals.reserve(vertex_count);
-						for (size_t i = 0; i < vertex_count; ++i)
-						{
-							normals.push_back(*(Vector3*)((size_t)data + i * stride));
-							if (material.double_sided)
+						normals.resize(vertex_count);
+						ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
 							{
-								normals.back().x *= -1;
-								normals.back().y *= -1;
-								normals.back().z *= -1;
-							}
-						}
+								normals[i] = *(Vector3*)((size_t)data + i * stride);
+								if (material.double_sided)
+								{
+									normals[i].x *= -1;
+									normals[i].y *= -1;
+									normals[i].z *= -1;
+								}
+							});
 					}
 					else if (!attr_name.compare("TANGENT"))
 					{
-						tangents.reserve(vertex_count);
-						for (size_t i = 0; i < vertex_count; ++i)
-						{
-							Vector4 tangent = *(Vector4*)((size_t)data + i * stride);
-							tangents.emplace_back(tangent.x, tangent.y, tangent.z);
-							tangent_handness.push_back(tangent.w);
-						}
+						tangents.resize(vertex_count);
+						tangent_handness.resize(vertex_count);
+						ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+							{
+								Vector4 tangent = *(Vector4*)((size_t)data + i * stride);
+								tangents[i] = Vector3(tangent.x, tangent.y, tangent.z);
+								tangent_handness[i] = tangent.w;
+							});
 					}
 					else if (!attr_name.compare("TEXCOORD_0"))
 					{
-						uvs.reserve(vertex_count);
 						if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
 						{
-							for (size_t i = 0; i < vertex_count; ++i)
-							{
-								Vector2 tex = *(Vector2*)((size_t)data + i * stride);
-								tex.y = 1.0f - tex.y;
-								uvs.push_back(tex);
-							}
+							uvs.resize(vertex_count);
+							ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+								{
+									Vector2 tex = *(Vector2*)((size_t)data + i * stride);
+									tex.y = 1.0f - tex.y;
+									uvs[i] = tex;
+								});
 						}
 						else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
 						{
-							for (size_t i = 0; i < vertex_count; ++i)
-							{
-								uint8_t const& s = *(uint8_t*)((size_t)data + i * stride + 0 * sizeof(uint8_t));
-								uint8_t const& t = *(uint8_t*)((size_t)data + i * stride + 1 * sizeof(uint8_t));
-								uvs.push_back(Vector2(s / 255.0f, 1.0f - t / 255.0f));
-							}
+							uvs.resize(vertex_count);
+							ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+								{
+									uint8_t const& s = *(uint8_t*)((size_t)data + i * stride + 0 * sizeof(uint8_t));
+									uint8_t const& t = *(uint8_t*)((size_t)data + i * stride + 1 * sizeof(uint8_t));
+									uvs[i] = Vector2(s / 255.0f, 1.0f - t / 255.0f);
+								});
 						}
 						else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
 						{
-							for (size_t i = 0; i < vertex_count; ++i)
-							{
-								uint16_t const& s = *(uint16_t*)((size_t)data + i * stride + 0 * sizeof(uint16_t));
-								uint16_t const& t = *(uint16_t*)((size_t)data + i * stride + 1 * sizeof(uint16_t));
-								uvs.push_back(Vector2(s / 65535.0f, 1.0f - t / 65535.0f));
-							}
+							uvs.resize(vertex_count);
+							ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+								{
+									uint16_t const& s = *(uint16_t*)((size_t)data + i * stride + 0 * sizeof(uint16_t));
+									uint16_t const& t = *(uint16_t*)((size_t)data + i * stride + 1 * sizeof(uint16_t));
+									uvs[i] = Vector2(s / 65535.0f, 1.0f - t / 65535.0f);
+								});
 						}
 					}
 				}
@@ -625,12 +699,12 @@ namespace Case_Engine
 				reg.emplace<Mesh>(e, mesh_component);
 				if (has_tangents)
 				{
-					for (uint64_t i = 0; i < vertex_count; ++i)
-					{
-						Vector3 bitangent = normals[i].Cross(tangents[i]) * tangent_handness[i];
-						bitangent.Normalize();
-						bitangents[i] = bitangent;
-					}
+					ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+						{
+							Vector3 bitangent = normals[i].Cross(tangents[i]) * tangent_handness[i];
+							bitangent.Normalize();
+							bitangents[i] = bitangent;
+						});
 				}
 				else
 				{
@@ -639,17 +713,18 @@ namespace Case_Engine
 					//	tangents.data(), bitangents.data());
 				}
 
-				vertices.reserve(vertices.size() + vertex_count);
-				for (uint64_t i = 0; i < vertex_count; ++i)
-				{
-					vertices.emplace_back(
-						positions[i],
-						uvs[i],
-						normals[i],
-						Vector3(tangents[i].x, tangents[i].y, tangents[i].z),
-						bitangents[i]
-					);
-				}
+				size_t const vertex_offset = vertices.size();
+				vertices.resize(vertex_offset + vertex_count);
+				ParallelFor(0, vertex_count, ATTRIBUTE_GRAIN, [&](size_t i)
+					{
+						vertices[vertex_offset + i] = CompleteVertex{
+							positions[i],
+							uvs[i],
+							normals[i],
+							Vector3(tangents[i].x, tangents[i].y, tangents[i].z),
+							bitangents[i]
+						};
+					});
 			}
 		}
 
@@ -739,34 +814,100 @@ namespace Case_Engine
 			LoadNode(scene.nodes[i], params.model_matrix);
 		}
 
-		std::shared_ptr<GfxBuffer> vb = std::make_shared<GfxBuffer>(gfx, VertexBufferDesc(vertices.size(), sizeof(CompleteVertex)), vertices.data());
-		std::shared_ptr<GfxBuffer> ib = std::make_shared<GfxBuffer>(gfx, IndexBufferDesc(indices.size(), false), indices.data());
+		GeometryRange vb = geometry_pool.AllocateVertices(vertices);
+		GeometryRange ib = geometry_pool.AllocateIndices(indices);
 
 		entity root = reg.create();
 		reg.emplace<Transform>(root);
-		reg.emplace<Tag>(root, model_name);
-		Relationship relationship;
-		relationship.children_count = (uint32_t)entities.size();
-		CASE_ENGINE_ASSERT(relationship.children_count <= Relationship::MAX_CHILDREN);
-		for (size_t i = 0; i < relationship.children_count; ++i)
-		{
-			relationship.children[i] = entities[i];
-		}
-		reg.add<Relationship>(root, relationship);
+		reg.emplace<Tag>(root, g_NameTable.Intern(model_name));
 
-		size_t i = 0;
+		std::string const submesh_prefix = model_name + " submesh";
+		std::vector<Tag> tags{};
+		tags.reserve(entities.size());
 		for (entity e : entities)
 		{
 			auto& mesh = reg.get<Mesh>(e);
-			mesh.vertex_buffer = vb;
-			mesh.index_buffer = ib;
-			reg.emplace<Tag>(e, model_name + " submesh" + std::to_string(i++));
-			reg.emplace<Relationship>(e, root);
+			mesh.vertex_buffer = vb.buffer;
+			mesh.index_buffer = ib.buffer;
+			mesh.start_index_location += ib.first;
+			mesh.base_vertex_location += static_cast<int32_t>(vb.first);
+			tags.push_back(Tag{ g_NameTable.Generate(submesh_prefix, tags.size()) });
 		}
+		reg.insert<Tag>(entities.begin(), entities.end(), tags.begin());
+		AttachChildren(reg, root, entities);
+
+		std::vector<entity> prefab_entities{ root };
+		prefab_entities.insert(prefab_entities.end(), entities.begin(), entities.end());
+		model_prefabs[params.model_path + params.textures_path] = ModelPrefab
+		{
+			tecs::prefab::capture<Transform, Relationship, Mesh, Material, Deferred, AABB, Tag>(reg, prefab_entities.begin(), prefab_entities.end()),
+			params.model_matrix,
+			model_name
+		};
 		
 		CASE_ENGINE_LOG(INFO, "GLTF Mesh %s successfully loaded!", params.model_path.c_str());
 		return entities;
 	}
+	std::vector<entity> ModelImporter::InstantiateModel_GLTF(ModelParameters const& params, std::span<Matrix const> model_matrices)
+	{
+		std::vector<entity> roots{};
+		if (model_matrices.empty()) return roots;
+
+		auto it = model_prefabs.find(params.model_path + params.textures_path);
+		if (it == model_prefabs.end())
+		{
+			ModelParameters first_params = params;
+			first_params.model_matrix = model_matrices.front();
+			std::vector<entity> entities = ImportModel_GLTF(first_params);
+			if (entities.empty()) return roots;
+
+			roots.push_back(reg.get<Relationship>(entities.front()).parent);
+			model_matrices = model_matrices.subspan(1);
+			it = model_prefabs.find(params.model_path + params.textures_path);
+		}
+
+		std::vector<entity> created = InstantiateModelPrefab(it->second, model_matrices);
+		size_t const prefab_size = it->second.prefab.size();
+		for (size_t i = 0; i < created.size(); i += prefab_size) roots.push_back(created[i]);
+		return roots;
+	}
+	std::vector<entity> ModelImporter::InstantiateModelPrefab(ModelPrefab& model_prefab, std::span<Matrix const> model_matrices)
+	{
+		std::vector<entity> created{};
+		created.reserve(model_prefab.prefab.size() * model_matrices.size());
+		model_prefab.prefab.instantiate(reg, model_matrices.size(), std::back_inserter(created));
+
+		//submesh transforms and bounding boxes were baked with the captured model matrix, the root carries the difference
+		Matrix const captured_inverse = model_prefab.model_matrix.Invert();
+		size_t const prefab_size = model_prefab.prefab.size();
+		for (size_t copy = 0; copy < model_matrices.size(); ++copy)
+		{
+			entity const root = created[copy * prefab_size];
+
+			//the captured tags name the first model, every copy gets names of its own so it can be found
+			NameId const root_name = g_NameTable.Generate(model_prefab.model_name + " ", ++model_prefab.instance_count);
+			reg.get<Tag>(root).name = root_name;
+			std::string const submesh_prefix = std::string(g_NameTable.CStr(root_name)) + " submesh";
+			for (size_t i = 1; i < prefab_size; ++i) reg.get<Tag>(created[copy * prefab_size + i]).name = g_NameTable.Generate(submesh_prefix, i - 1);
+
+			Matrix const offset = captured_inverse * model_matrices[copy];
+			if (offset == Matrix::Identity) continue;
+
+			auto& root_transform = reg.get<Transform>(root);
+			root_transform.starting_transform = offset;
+			root_transform.current_transform = offset;
+
+			for (size_t i = 1; i < prefab_size; ++i)
+			{
+				if (AABB* aabb = reg.get_if<AABB>(created[copy * prefab_size + i]))
+				{
+					aabb->bounding_box.Transform(aabb->bounding_box, offset);
+					aabb->UpdateBuffer(gfx);
+				}
+			}
+		}
+		return created;
+	}
     entity ModelImporter::LoadSkybox(SkyboxParameters const& params)
     {
         entity skybox = reg.create();
@@ -778,7 +919,7 @@ namespace Case_Engine
         else sky.cubemap_texture = g_TextureManager.LoadCubeMap(params.cubemap_textures);
 
         reg.emplace<Skybox>(skybox, sky);
-        reg.emplace<Tag>(skybox, "Skybox");
+        reg.emplace<Tag>(skybox, g_NameTable.Intern("Skybox"));
         
         return skybox;
     }
@@ -806,10 +947,14 @@ namespace Case_Engine
                     0, 2, 1, 2, 0, 3
             };
 
+            GeometryRange vb = geometry_pool.AllocateVertices(vertices);
+            GeometryRange ib = geometry_pool.AllocateIndices(indices);
 			Mesh mesh{};
-			mesh.vertex_buffer = std::make_shared<GfxBuffer>(gfx, VertexBufferDesc(vertices.size(), sizeof(TexturedVertex)), vertices.data());
-			mesh.index_buffer = std::make_shared<GfxBuffer>(gfx, IndexBufferDesc(indices.size(), true), indices.data());
+			mesh.vertex_buffer = vb.buffer;
+			mesh.index_buffer = ib.buffer;
             mesh.indices_count = static_cast<uint32_t>(indices.size());
+            mesh.start_index_location = ib.first;
+            mesh.base_vertex_location = static_cast<int32_t>(vb.first);
 
             reg.emplace<Mesh>(light, mesh);
 
@@ -917,13 +1062,13 @@ namespace Case_Engine
         switch (params.light_data.type)
         {
         case LightType::Directional:
-            reg.emplace<Tag>(light, "Directional Light");
+            reg.emplace<Tag>(light, g_NameTable.Intern("Directional Light"));
             break;
         case LightType::Spot:
-            reg.emplace<Tag>(light, "Spot Light");
+            reg.emplace<Tag>(light, g_NameTable.Intern("Spot Light"));
             break;
         case LightType::Point:
-            reg.emplace<Tag>(light, "Point Light");
+            reg.emplace<Tag>(light, g_NameTable.Intern("Point Light"));
             break;
         }
 
@@ -938,11 +1083,11 @@ namespace Case_Engine
         ocean_material.shader = ShaderProgram::Unknown; 
 
         Ocean ocean_component{};
+        reg.insert<Material>(ocean_chunks.begin(), ocean_chunks.end(), ocean_material);
+        reg.insert<Ocean>(ocean_chunks.begin(), ocean_chunks.end(), ocean_component);
         for (auto ocean_chunk : ocean_chunks)
         {
-            reg.emplace<Material>(ocean_chunk, ocean_material);
-            reg.emplace<Ocean>(ocean_chunk, ocean_component);
-            reg.emplace<Tag>(ocean_chunk, "Ocean Chunk" + std::to_string(as_integer(ocean_chunk)));
+            reg.emplace<Tag>(ocean_chunk, g_NameTable.Generate("Ocean Chunk", as_integer(ocean_chunk)));
         }
 
         return ocean_chunks;
@@ -973,7 +1118,7 @@ namespace Case_Engine
 		for (auto terrain_chunk : terrain_chunks)
 		{
 			reg.emplace<TerrainComponent>(terrain_chunk, terrain_component);
-			reg.emplace<Tag>(terrain_chunk, "Terrain Chunk" + std::to_string(as_integer(terrain_chunk)));
+			reg.emplace<Tag>(terrain_chunk, g_NameTable.Generate("Terrain Chunk", as_integer(terrain_chunk)));
 		}
 
 		return terrain_chunks;
@@ -1158,7 +1303,7 @@ namespace Case_Engine
 		reg.add(emitter_entity, emitter);
 
         if (params.name.empty()) reg.emplace<Tag>(emitter_entity);
-        else reg.emplace<Tag>(emitter_entity, params.name);
+        else reg.emplace<Tag>(emitter_entity, g_NameTable.Intern(params.name));
 
         return emitter_entity;
 	}
@@ -1194,8 +1339,8 @@ namespace Case_Engine
         
         entity decal_entity = reg.create();
         reg.add(decal_entity, decal);
-		if (params.name.empty()) reg.emplace<Tag>(decal_entity, "decal");
-		else reg.emplace<Tag>(decal_entity, params.name);
+		if (params.name.empty()) reg.emplace<Tag>(decal_entity, g_NameTable.Intern("decal"));
+		else reg.emplace<Tag>(decal_entity, g_NameTable.Intern(params.name));
 
         return decal_entity;
 	}
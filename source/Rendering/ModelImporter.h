@@ -9,10 +9,14 @@
 #include <array>
 #include <vector>
 #include "Components.h"
+#include "GeometryBufferPool.h"
 #include "Core/Paths.h"
 #include "Math/ComputeNormals.h"
 #include "Utilities/Heightmap.h"
+#include "Utilities/HashMap.h"
+#include "Utilities/Task.h"
 #include "tecs/entity.h"
+#include "tecs/prefab.h"
 
 
 // Namespace Case_Engine
@@ -156,6 +160,7 @@ namespace Case_Engine
     }
     class TextureManager;
 	class GfxDevice;
+	struct ParsedModel_GLTF;
 
 	class ModelImporter
 	{
@@ -165,6 +170,10 @@ namespace Case_Engine
         ModelImporter(tecs::registry& reg, GfxDevice* gfx);
 
         [[maybe_unused]] std::vector<tecs::entity> ImportModel_GLTF(ModelParameters const&);
+        //reads and parses the file on a worker, the registry is only touched once the task is back on the main thread
+        Task<std::vector<tecs::entity>> ImportModelAsync_GLTF(ModelParameters params);
+        //one root per model matrix, the file is parsed only the first time it is imported
+        [[maybe_unused]] std::vector<tecs::entity> InstantiateModel_GLTF(ModelParameters const&, std::span<Matrix const> model_matrices);
 
         [[nodiscard]] std::vector<tecs::entity> LoadObjMesh(std::string const& model_path, std::vector<std::string>* diffuse_textures_out = nullptr);
 
@@ -180,11 +189,23 @@ namespace Case_Engine
 	private:
         tecs::registry& reg;
 		GfxDevice* gfx;
+        GeometryBufferPool geometry_pool;
+
+        struct ModelPrefab
+        {
+            tecs::prefab prefab;
+            Matrix model_matrix;
+            std::string model_name;
+            uint64_t instance_count = 0;
+        };
+        HashMap<std::string, ModelPrefab> model_prefabs;
 
     private:
 
 
+        [[nodiscard]] std::vector<tecs::entity> CreateModel_GLTF(ModelParameters const&, ParsedModel_GLTF&);
         [[nodiscard]] std::vector<tecs::entity> LoadGrid(GridParameters const& args, std::vector<TexturedNormalVertex>* vertices = nullptr);
+        [[nodiscard]] std::vector<tecs::entity> InstantiateModelPrefab(ModelPrefab&, std::span<Matrix const> model_matrices);
 	};
 }
 
@@ -8,10 +8,12 @@
 #include "Renderer.h"
 #include "Camera.h"
 #include "Components.h"
+#include "SceneGraph.h"
 #include "ShaderManager.h"
 #include "SkyModel.h"
 #include "Core/Logger.h"
 #include "Core/Paths.h"
+#include "Core/CpuProfiler.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommandContext.h"
 #include "Graphics/GfxStates.h"
@@ -20,6 +22,8 @@
 #include "Math/Halton.h"
 #include "Utilities/Random.h"
 #include "Utilities/StringUtil.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/FrameArena.h"
 #include "DDSTextureLoader.h"
 
 
@@ -290,9 +294,11 @@ namespace Case_Engine
 	}
 
 	Renderer::Renderer(registry& reg, GfxDevice* gfx, uint32_t width, uint32_t height)
-		: width(width), height(height), reg(reg), gfx(gfx), particle_renderer(gfx), picker(gfx)
+		: width(width), height(height), reg(reg), gfx(gfx), particle_renderer(gfx), picker(gfx), update_systems(reg)
 	{
 		g_GfxProfiler.Initialize(gfx);
+		reg.track<Light, Transform, Relationship>();
+		RegisterUpdateSystems();
 		CreateRenderStates();
 		CreateBuffers();
 		CreateSamplers();
@@ -309,15 +315,10 @@ namespace Case_Engine
 
 	void Renderer::Update(float dt)
 	{
+		CaseEngineCpuProfileScope("Renderer Update");
 		current_dt = dt;
-		UpdateLights();
-		UpdateTerrainData();
-		UpdateVoxelData();
-		CameraFrustumCulling();
-		UpdateCBuffers(dt);
-		UpdateWeather(dt);
-		UpdateOcean(dt);
-		UpdateParticles(dt);
+		JobExecutor frame_jobs = g_ThreadPool.Executor(JobPriority::Critical);
+		update_systems.run(frame_jobs);
 	}
 	void Renderer::SetSceneViewportData(SceneViewport const& vp)
 	{
@@ -474,6 +475,28 @@ namespace Case_Engine
 	{
 		return g_GfxProfiler.GetProfilingResults();
 	}
+	std::vector<tecs::system_timing> const& Renderer::GetSystemTimings() const
+	{
+		return update_systems.get_timings();
+	}
+
+	void Renderer::RegisterUpdateSystems()
+	{
+		//gpu updates and stages that fan out onto g_ThreadPool themselves stay on the main thread
+		update_systems.add("World Transforms", reads<>, writes<Transform, Relationship>, [this]()
+			{
+				UpdateWorldTransforms(reg, transforms_tick);
+				transforms_tick = reg.tick();
+			});
+		update_systems.add("Lights", reads<Light>, writes<>, [this]() { UpdateLights(); }, system_affinity::main_thread);
+		update_systems.add("Terrain Data", reads<Ocean>, writes<>, [this]() { UpdateTerrainData(); }, system_affinity::main_thread);
+		update_systems.add("Voxel Data", reads<>, writes<>, [this]() { UpdateVoxelData(); }, system_affinity::main_thread);
+		update_systems.add("Camera Culling", reads<Light>, writes<AABB>, [this]() { CameraFrustumCulling(); }, system_affinity::main_thread);
+		update_systems.add("Constant Buffers", reads<>, writes<>, [this]() { UpdateCBuffers(current_dt); }, system_affinity::main_thread);
+		update_systems.add("Weather", reads<Light>, writes<>, [this]() { UpdateWeather(current_dt); }, system_affinity::main_thread);
+		update_systems.add("Ocean", reads<Ocean>, writes<Material>, [this]() { UpdateOcean(current_dt); }, system_affinity::main_thread);
+		update_systems.add("Particles", reads<>, writes<Emitter>, [this]() { UpdateParticles(current_dt); });
+	}
 
 	void Renderer::LoadTextures()
 	{
@@ -1263,14 +1286,14 @@ namespace Case_Engine
 		if (reg.size<Ocean>() == 0) return;
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Ocean Update Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Ocean Update Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Ocean Update Pass");
 
 		if (renderer_settings.ocean_color_changed)
 		{
 			auto ocean_view = reg.view<Ocean, Material>();
-			for (auto e : ocean_view)
+			for (auto [e, ocean, material] : ocean_view.each())
 			{
-				auto& material = ocean_view.get<Material>(e);
 				material.diffuse = Vector3(renderer_settings.ocean_color);
 			}
 		}
@@ -1449,17 +1472,22 @@ namespace Case_Engine
 			lights->CreateSRV();
 		}
 
-		std::vector<LightSBuffer> lights_data{};
-
 		auto light_view = reg.view<Light>();
+		Matrix const view = camera->View();
+		if (!light_count_changed && view == lights_view && !light_view.any_changed(lights_tick)) return;
+		lights_tick = reg.tick();
+		lights_view = view;
+
+		FrameVector<LightSBuffer> lights_data{};
+		lights_data.reserve(light_view.size());
 		for (auto e : light_view)
 		{
 			LightSBuffer light_data{};
 			auto& light = light_view.get(e);
 
 			light_data.color = light.color * light.energy;
-			light_data.position  = Vector4::Transform(light.position, camera->View());
-			light_data.direction = Vector4::Transform(light.direction, camera->View());
+			light_data.position  = Vector4::Transform(light.position, view);
+			light_data.direction = Vector4::Transform(light.direction, view);
 			light_data.range = light.range;
 			light_data.type = static_cast<int32_t>(light.type);
 			light_data.inner_cosine = light.inner_cosine;
@@ -1508,37 +1536,63 @@ namespace Case_Engine
 	}
 	void Renderer::CameraFrustumCulling()
 	{
+		CaseEngineCpuProfileScope("Camera Culling");
 		BoundingFrustum camera_frustum = camera->Frustum();
 		auto aabb_view = reg.view<AABB>();
-		for (auto e : aabb_view)
+		auto light_view = reg.view<Light>();
+		auto [center_x, center_y, center_z, extents_x, extents_y, extents_z, flags] = aabb_view.streams();
+		JobExecutor frame_jobs = g_ThreadPool.Executor(JobPriority::Critical);
+		aabb_view.par_chunks(frame_jobs, [&](size_t first, size_t last)
 		{
-			auto& aabb = aabb_view.get(e);
-			if (aabb.skip_culling) continue;
-			aabb.camera_visible = camera_frustum.Intersects(aabb.bounding_box) || reg.has<Light>(e); //dont cull lights for now
-		}
+			for (size_t i = first; i < last; ++i)
+			{
+				if (flags[i] & AABBFlag_SkipCulling) continue;
+				BoundingBox box(Vector3(center_x[i], center_y[i], center_z[i]), Vector3(extents_x[i], extents_y[i], extents_z[i]));
+				bool visible = camera_frustum.Intersects(box);
+				bool const was_visible = flags[i] & AABBFlag_CameraVisible;
+				if (visible == was_visible) continue;
+
+				entity e = aabb_view[i];
+				if (!visible && light_view.contains(e)) continue; //dont cull lights for now
+				flags[i] ^= AABBFlag_CameraVisible;
+				aabb_view.get(e).camera_visible = visible;
+			}
+		});
 	}
 	void Renderer::LightFrustumCulling(LightType type)
 	{
-		auto visibility_view = reg.view<AABB>();
-		for (auto e : visibility_view)
+		CaseEngineCpuProfileScope("Light Culling");
+		auto visibility_view = reg.view<AABB>(exclude<Light>);
+		auto [center_x, center_y, center_z, extents_x, extents_y, extents_z, flags] = visibility_view.streams();
+		JobExecutor frame_jobs = g_ThreadPool.Executor(JobPriority::Critical);
+		visibility_view.par_chunks(frame_jobs, [&](size_t first, size_t last)
 		{
-			if (reg.has<Light>(e)) continue; 
-			auto& aabb = visibility_view.get(e);
-			if (aabb.skip_culling) continue;
-
-			switch (type)
+			for (size_t i = first; i < last; ++i)
 			{
-			case LightType::Directional:
-				aabb.light_visible = light_bounding_box.Intersects(aabb.bounding_box);
-				break;
-			case LightType::Spot:
-			case LightType::Point:
-				aabb.light_visible = light_bounding_frustum.Intersects(aabb.bounding_box);
-				break;
-			default:
-				CASE_ENGINE_ASSERT(false);
+				if (flags[i] & AABBFlag_SkipCulling) continue;
+				BoundingBox box(Vector3(center_x[i], center_y[i], center_z[i]), Vector3(extents_x[i], extents_y[i], extents_z[i]));
+				bool visible = false;
+				switch (type)
+				{
+				case LightType::Directional:
+					visible = light_bounding_box.Intersects(box);
+					break;
+				case LightType::Spot:
+				case LightType::Point:
+					visible = light_bounding_frustum.Intersects(box);
+					break;
+				default:
+					CASE_ENGINE_ASSERT(false);
+				}
+				bool const was_visible = flags[i] & AABBFlag_LightVisible;
+				if (visible == was_visible) continue;
+
+				entity e = visibility_view[i];
+				if (!visibility_view.contains(e)) continue;
+				flags[i] ^= AABBFlag_LightVisible;
+				visibility_view.get(e).light_visible = visible;
 			}
-		}
+		});
 	}
 
 	void Renderer::PassPicking()
@@ -1553,6 +1607,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "GBuffer Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("GBuffer Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "GBuffer Pass");
 
 		command_context->UnsetShaderResourcesRO(GfxShaderStage::PS, 0, (uint32_t)gbuffer.size() + 1);
@@ -1562,38 +1617,46 @@ namespace Case_Engine
 			bool double_sided;
 			auto operator<=>(BatchParams const&) const = default;
 		};
-		std::map<BatchParams, std::vector<entity>> batched_entities;
 
-		auto gbuffer_view = reg.view<Mesh, Transform, Material, Deferred, AABB>();
-		for (auto e : gbuffer_view)
+		auto gbuffer_group = reg.group<Mesh, Transform, AABB>();
+		auto gbuffer_view = reg.view<Material, Deferred>();
+		auto GetBatchParams = [&](entity e)
 		{
-			auto [mesh, transform, material, aabb] = gbuffer_view.get<Mesh, Transform, Material, AABB>(e);
-			if (!aabb.camera_visible) continue;
+			auto const& material = gbuffer_view.get<Material>(e);
 
 			BatchParams params{};
 			params.double_sided = material.double_sided;
 			params.shader_program = material.alpha_mode == MaterialAlphaMode::Opaque ? ShaderProgram::GBufferPBR : ShaderProgram::GBufferPBR_Mask;
-			batched_entities[params].push_back(e);
-		}
+			return params;
+		};
+
+		//materials rarely change, so keeping the group sorted by batch is close to linear each frame
+		gbuffer_group.sort([&](entity lhs, entity rhs)
+		{
+			bool const lhs_deferred = gbuffer_view.contains(lhs), rhs_deferred = gbuffer_view.contains(rhs);
+			if (lhs_deferred != rhs_deferred) return lhs_deferred;
+			return lhs_deferred && GetBatchParams(lhs) < GetBatchParams(rhs);
+		});
 		
 		command_context->BeginRenderPass(gbuffer_pass);
 		{
-			for (auto const& [params, entities] : batched_entities)
-			{
-				ShaderManager::GetShaderProgram(params.shader_program)->Bind(command_context);
-				if (params.double_sided) command_context->SetRasterizerState(cull_none.get()); 
-				for (auto e : entities)
+			std::optional<BatchParams> current_batch;
+			gbuffer_group.each([&](entity e, Mesh& mesh, Transform& transform, AABB& aabb)
 				{
-					auto [mesh, transform, material] = gbuffer_view.get<Mesh, Transform, Material>(e);
+					if (!aabb.camera_visible || !gbuffer_view.contains(e)) return;
 
-					Matrix parent_transform = Matrix::Identity;
-					if (Relationship* relationship = reg.get_if<Relationship>(e))
+					BatchParams const params = GetBatchParams(e);
+					if (params != current_batch)
 					{
-						if (auto* root_transform = reg.get_if<Transform>(relationship->parent)) parent_transform = root_transform->current_transform;
+						if (current_batch && current_batch->double_sided) command_context->SetRasterizerState(nullptr);
+						ShaderManager::GetShaderProgram(params.shader_program)->Bind(command_context);
+						if (params.double_sided) command_context->SetRasterizerState(cull_none.get());
+						current_batch = params;
 					}
-					
-					object_cbuf_data.model = transform.current_transform * parent_transform;
-					object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+					auto& material = gbuffer_view.get<Material>(e);
+
+					object_cbuf_data.model = transform.world;
+					object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 					object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 
 					material_cbuf_data.albedo_factor = material.albedo_factor;
@@ -1643,20 +1706,17 @@ namespace Case_Engine
 					}
 
 					mesh.Draw(command_context);
-				}
-				if (params.double_sided) command_context->SetRasterizerState(nullptr);
-			}
+				});
+			if (current_batch && current_batch->double_sided) command_context->SetRasterizerState(nullptr);
 			
 			auto terrain_view = reg.view<Mesh, Transform, AABB, TerrainComponent>();
 			ShaderManager::GetShaderProgram(ShaderProgram::GBuffer_Terrain)->Bind(command_context);
-			for (auto e : terrain_view)
+			for (auto [e, mesh, transform, aabb, terrain] : terrain_view.each())
 			{
-				auto [mesh, transform, aabb, terrain] = terrain_view.get<Mesh, Transform, AABB, TerrainComponent>(e);
-
 				if (!aabb.camera_visible) continue;
 
-				object_cbuf_data.model = transform.current_transform;
-				object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert().Transpose();
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world.Transpose();
 				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 
 				if (terrain.grass_texture != INVALID_TEXTURE_HANDLE)
@@ -1690,13 +1750,12 @@ namespace Case_Engine
 
 			auto foliage_view = reg.view<Mesh, Transform, Material, AABB, Foliage>();
 			ShaderManager::GetShaderProgram(ShaderProgram::GBuffer_Foliage)->Bind(command_context);
-			for (auto e : foliage_view)
+			for (auto [e, mesh, transform, material, aabb, foliage] : foliage_view.each())
 			{
-				auto [mesh, transform, aabb, material] = foliage_view.get<Mesh, Transform, AABB, Material>(e);
 				if (!aabb.camera_visible) continue;
 
-				object_cbuf_data.model = transform.current_transform;
-				object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert().Transpose();
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world.Transpose();
 				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 
 				if (material.albedo_texture != INVALID_TEXTURE_HANDLE)
@@ -1714,6 +1773,7 @@ namespace Case_Engine
 		if (reg.size<Decal>() == 0) return;
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Decals Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Decals Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Decals Pass");
 
 		struct DecalCBuffer
@@ -1736,7 +1796,7 @@ namespace Case_Engine
 			command_context->SetRasterizerState(cull_none.get());
 			for (auto e : decal_view)
 			{
-				Decal decal = decal_view.get(e);
+				Decal const& decal = decal_view.get(e);
 				decal.modify_gbuffer_normals 
 					? ShaderManager::GetShaderProgram(ShaderProgram::Decals_ModifyNormals)->Bind(command_context) 
 					: ShaderManager::GetShaderProgram(ShaderProgram::Decals)->Bind(command_context);
@@ -1762,6 +1822,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "SSAO Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("SSAO Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "SSAO Pass");
 
 		command_context->UnsetShaderResourcesRO(GfxShaderStage::PS, 7, 1);
@@ -1792,6 +1853,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "HBAO Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("HBAO Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "HBAO Pass");
 
 		command_context->UnsetShaderResourcesRO(GfxShaderStage::PS, 7, 1);
@@ -1823,6 +1885,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Ambient Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Ambient Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Ambient Pass");
 
 		GfxShaderResourceRO srvs[] = { gbuffer[GBufferSlot_NormalMetallic]->SRV(),gbuffer[GBufferSlot_DiffuseRoughness]->SRV(), depth_target->SRV(), gbuffer[GBufferSlot_Emissive]->SRV() };
@@ -1855,6 +1918,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Deferred Lighting Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Deferred Lighting Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Deferred Lighting Pass");
 
 		command_context->SetBlendState(additive_blend.get());
@@ -1937,6 +2001,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Deferred Tiled Lighting Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Deferred Tiled Lighting Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Deferred Tiled Lighting Pass");
 
 		GfxShaderResourceRO shader_views[3] = { nullptr };
@@ -1982,7 +2047,7 @@ namespace Case_Engine
 		command_context->ClearReadWriteDescriptorFloat(debug_uav, black);
 		command_context->ClearReadWriteDescriptorFloat(texture_uav, black);
 
-		std::vector<Light> volumetric_lights{};
+		FrameVector<Light> volumetric_lights{};
 
 		auto light_view = reg.view<Light>();
 		for (auto e : light_view)
@@ -2021,6 +2086,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Deferred Clustered Lighting Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Deferred Clustered Lighting Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Deferred Clustered Lighting Pass");
 
 		if (recreate_clusters)
@@ -2071,7 +2137,7 @@ namespace Case_Engine
 			command_context->UnsetShaderResourcesRO(GfxShaderStage::PS, 0, ARRAYSIZE(shader_views));
 
 			//Volumetric lighting for non-shadow casting lights
-			std::vector<Light> volumetric_lights{};
+			FrameVector<Light> volumetric_lights{};
 			auto light_view = reg.view<Light>();
 			for (auto e : light_view)
 			{
@@ -2107,6 +2173,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Forward Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Forward Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Forward Pass");
 
 		command_context->BeginRenderPass(forward_pass); 
@@ -2124,9 +2191,10 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT_MSG(false, "Voxel GI is not working");
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Voxelization Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Voxelization Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Voxelization Pass");
 
-		std::vector<LightSBuffer> _lights{};
+		FrameVector<LightSBuffer> _lights{};
 		auto light_view = reg.view<Light>();
 		for (auto e : light_view)
 		{
@@ -2161,14 +2229,12 @@ namespace Case_Engine
 		GfxShaderResourceRO lights_srv = lights->SRV();
 		command_context->SetShaderResourceRO(GfxShaderStage::PS, 10, lights_srv);
 
-		for (auto e : voxel_view)
+		for (auto [e, mesh, transform, material, deferred, aabb] : voxel_view.each())
 		{
-			auto [mesh, transform, material, aabb] = voxel_view.get<Mesh, Transform, Material, AABB>(e);
-
 			if (!aabb.camera_visible) continue;
 
-			object_cbuf_data.model = transform.current_transform;
-			object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+			object_cbuf_data.model = transform.world;
+			object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 			object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 
 			material_cbuf_data.albedo_factor = material.albedo_factor;
@@ -2214,6 +2280,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT_MSG(false, "Voxel GI is not working");
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Voxelization Debug Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Voxelization Debug Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Voxelization Debug Pass");
 
 		command_context->BeginRenderPass(voxel_debug_pass);
@@ -2237,6 +2304,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT_MSG(false, "Voxel GI is not working");
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Voxel GI Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Voxel GI Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Voxel GI Pass");
 
 		command_context->SetBlendState(additive_blend.get());
@@ -2262,6 +2330,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Postprocessing Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Postprocessing Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Postprocessing Pass");
 
 		PassMotionVectors();
@@ -2387,6 +2456,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.type == LightType::Directional);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Directional Shadow Map Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Directional Shadow Map Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Directional Shadow Map Pass");
 		
 		auto const& [V, P] = scene_bounding_sphere ? LightViewProjection_Directional(light, *scene_bounding_sphere, light_bounding_box)
@@ -2415,6 +2485,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.type == LightType::Spot);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Spot Shadow Map Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Spot Shadow Map Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Spot Shadow Map Pass");
 
 		auto const& [V, P] = LightViewProjection_Spot(light, light_bounding_frustum);
@@ -2442,6 +2513,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.type == LightType::Point);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Point Shadow Map Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Point Shadow Map Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Point Shadow Map Pass");
 
 		for (uint32_t i = 0; i < shadow_cubemap_pass.size(); ++i)
@@ -2470,6 +2542,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.type == LightType::Directional);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Cascades Shadow Map Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Cascades Shadow Map Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Cascades Shadow Map Pass");
 
 		std::array<float, CASCADE_COUNT> split_distances;
@@ -2515,63 +2588,44 @@ namespace Case_Engine
 	void Renderer::PassShadowMapCommon()
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
-		auto shadow_view = reg.view<Mesh, Transform, AABB>();
+		auto shadow_group = reg.group<Mesh, Transform, AABB>();
+		auto material_view = reg.view<Material>();
 		if (!renderer_settings.shadow_transparent)
 		{
 			ShaderManager::GetShaderProgram(ShaderProgram::DepthMap)->Bind(command_context);
-			for (auto e : shadow_view)
+			shadow_group.each([&](entity e, Mesh const& mesh, Transform const& transform, AABB const& aabb)
 			{
-				auto& aabb = shadow_view.get<AABB>(e);
-				if (aabb.light_visible)
-				{
-					auto const& transform = shadow_view.get<Transform>(e);
-					auto const& mesh = shadow_view.get<Mesh>(e);
+				if (!aabb.light_visible) return;
 
-					Matrix parent_transform = Matrix::Identity;
-					if (Relationship* relationship = reg.get_if<Relationship>(e))
-					{
-						if (auto* root_transform = reg.get_if<Transform>(relationship->parent)) parent_transform = root_transform->current_transform;
-					}
-
-					object_cbuf_data.model = transform.current_transform * parent_transform;
-					object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
-					object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
-					mesh.Draw(command_context);
-				}
-			}
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world;
+				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
+				mesh.Draw(command_context);
+			});
 		}
 		else
 		{
-			std::vector<entity> potentially_transparent, not_transparent;
-			for (auto e : shadow_view)
+			FrameVector<entity> potentially_transparent, not_transparent;
+			shadow_group.each([&](entity e, Mesh const&, Transform const&, AABB const& aabb)
 			{
-				auto const& aabb = shadow_view.get<AABB>(e);
-				if (aabb.light_visible)
+				if (!aabb.light_visible) return;
+
+				if (Material const* p_material = material_view.get_if(e))
 				{
-					if (auto* p_material = reg.get_if<Material>(e))
-					{
-						if (p_material->albedo_texture != INVALID_TEXTURE_HANDLE)
-							potentially_transparent.push_back(e);
-						else not_transparent.push_back(e);
-					}
+					if (p_material->albedo_texture != INVALID_TEXTURE_HANDLE)
+						potentially_transparent.push_back(e);
 					else not_transparent.push_back(e);
 				}
-			}
+				else not_transparent.push_back(e);
+			});
 
 			ShaderManager::GetShaderProgram(ShaderProgram::DepthMap)->Bind(command_context);
 			for (auto e : not_transparent)
 			{
-				auto& transform = shadow_view.get<Transform>(e);
-				auto& mesh = shadow_view.get<Mesh>(e);
-
-				Matrix parent_transform = Matrix::Identity;
-				if (Relationship* relationship = reg.get_if<Relationship>(e))
-				{
-					if (auto* root_transform = reg.get_if<Transform>(relationship->parent)) parent_transform = root_transform->current_transform;
-				}
+				auto [transform, mesh] = shadow_group.get<Transform, Mesh>(e);
 
-				object_cbuf_data.model = transform.current_transform * parent_transform;
-				object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 				mesh.Draw(command_context);
 			}
@@ -2579,20 +2633,13 @@ namespace Case_Engine
 			ShaderManager::GetShaderProgram(ShaderProgram::DepthMap_Transparent)->Bind(command_context);
 			for (auto e : potentially_transparent)
 			{
-				auto& transform = shadow_view.get<Transform>(e);
-				auto& mesh = shadow_view.get<Mesh>(e);
-				auto* material = reg.get_if<Material>(e);
+				auto [transform, mesh] = shadow_group.get<Transform, Mesh>(e);
+				Material const* material = material_view.get_if(e);
 				CASE_ENGINE_ASSERT(material != nullptr);
 				CASE_ENGINE_ASSERT(material->albedo_texture != INVALID_TEXTURE_HANDLE);
 
-				Matrix parent_transform = Matrix::Identity;
-				if (Relationship* relationship = reg.get_if<Relationship>(e))
-				{
-					if (auto* root_transform = reg.get_if<Transform>(relationship->parent)) parent_transform = root_transform->current_transform;
-				}
-
-				object_cbuf_data.model = transform.current_transform * parent_transform;
-				object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 
 				auto view = g_TextureManager.GetTextureView(material->albedo_texture);
@@ -2612,6 +2659,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.volumetric);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Volumetric Lighting Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Volumetric Lighting Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Volumetric Lighting Pass");
 
 		GfxShaderResourceRO srv[] = { depth_target->SRV() };
@@ -2641,6 +2689,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Sky Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Sky Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Sky Pass");
 
 		object_cbuf_data.model = Matrix::CreateTranslation(camera->Position());
@@ -2687,6 +2736,7 @@ namespace Case_Engine
 
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Ocean Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Ocean Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Ocean Pass");
 
 		if (renderer_settings.ocean_wireframe) command_context->SetRasterizerState(wireframe.get());
@@ -2715,14 +2765,12 @@ namespace Case_Engine
 											: ShaderManager::GetShaderProgram(ShaderProgram::Ocean)->Bind(command_context);
 
 		auto ocean_chunk_view = reg.view<Mesh, Material, Transform, AABB, Ocean>();
-		for (auto ocean_chunk : ocean_chunk_view)
+		for (auto [ocean_chunk, mesh, material, transform, aabb, ocean] : ocean_chunk_view.each())
 		{
-			auto [mesh, material, transform, aabb] = ocean_chunk_view.get<const Mesh, const Material, const Transform, const AABB>(ocean_chunk);
-
 			if (aabb.camera_visible)
 			{
-				object_cbuf_data.model = transform.current_transform;
-				object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+				object_cbuf_data.model = transform.world;
+				object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 				object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 				
 				material_cbuf_data.diffuse = material.diffuse;
@@ -2748,6 +2796,7 @@ namespace Case_Engine
 		if (reg.size<Emitter>() == 0) return;
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Particles Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Particles Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Particles Pass");
 
 		command_context->BeginRenderPass(particle_pass);
@@ -2801,18 +2850,15 @@ namespace Case_Engine
 		auto forward_view = reg.view<Mesh, Transform, AABB, Material, Forward>();
 
 		if (transparent) command_context->SetBlendState(alpha_blend.get());
-		for (auto e : forward_view)
+		auto render_state_view = reg.view<RenderState>();
+		for (auto [e, mesh, transform, aabb, material, forward] : forward_view.each())
 		{
-			auto [forward, aabb] = forward_view.get<Forward const, AABB const>(e);
-
 			if (!(aabb.camera_visible && forward.transparent == transparent)) continue;
-			
-			auto [transform, mesh, material] = forward_view.get<Transform, Mesh, Material>(e);
 
 			ShaderManager::GetShaderProgram(material.shader)->Bind(command_context);
 
-			object_cbuf_data.model = transform.current_transform;
-			object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+			object_cbuf_data.model = transform.world;
+			object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 			object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 				
 			material_cbuf_data.diffuse = material.diffuse;
@@ -2825,7 +2871,7 @@ namespace Case_Engine
 				command_context->SetShaderResourceRO(GfxShaderStage::PS, TEXTURE_SLOT_DIFFUSE, view);
 			}
 
-			auto const* states = reg.get_if<RenderState>(e);
+			auto const* states = render_state_view.get_if(e);
 			if (states) ResolveCustomRenderState(*states, false);
 			mesh.Draw(command_context);
 			if (states) ResolveCustomRenderState(*states, true);
@@ -2839,6 +2885,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.lens_flare);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Lens Flare Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Lens Flare Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Lens Flare Pass");
 
 		if (light.type != LightType::Directional) 
@@ -2878,6 +2925,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.clouds);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Volumetric Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Volumetric Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Volumetric Pass");
 
 		GfxShaderResourceRO srv_array[] = { clouds_textures[0], clouds_textures[1], clouds_textures[2], depth_target->SRV()};
@@ -2904,6 +2952,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.ssr);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "SSR Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("SSR Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "SSR Pass");
 
 		postprocess_cbuf_data.ssr_ray_hit_threshold = renderer_settings.ssr_ray_hit_threshold;
@@ -2924,6 +2973,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(light.god_rays);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "God Rays Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("God Rays Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "God Rays Pass");
 
 		if (light.type != LightType::Directional)
@@ -2977,6 +3027,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.dof);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Depth of Field Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Depth of Field Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Depth of Field Pass");
 
 		if (renderer_settings.bokeh)
@@ -3053,6 +3104,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.bloom);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Bloom Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Bloom Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Bloom Pass");
 
 		GfxShaderResourceRW uav[] = { bloom_extract_texture->UAV() };
@@ -3084,6 +3136,7 @@ namespace Case_Engine
 		if (!renderer_settings.motion_blur && !(renderer_settings.anti_aliasing & AntiAliasing_TAA)) return;
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Velocity Buffer Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Velocity Buffer Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Velocity Buffer Pass");
 
 		postprocess_cbuf_data.velocity_buffer_scale = renderer_settings.velocity_buffer_scale;
@@ -3106,6 +3159,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.motion_blur);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Motion Blur Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Motion Blur Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Motion Blur Pass");
 
 		GfxShaderResourceRO srvs[] = { postprocess_textures[!postprocess_index]->SRV(), velocity_buffer->SRV() };
@@ -3123,6 +3177,7 @@ namespace Case_Engine
 		CASE_ENGINE_ASSERT(renderer_settings.fog);
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Fog Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Fog Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Fog Pass");
 
 		postprocess_cbuf_data.fog_falloff = renderer_settings.fog_falloff;
@@ -3146,6 +3201,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Film Effects Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Film Effects Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Film Effects Pass");
 
 		auto GetFilmGrainSeed = [](float dt, float seed_update_rate)
@@ -3185,6 +3241,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Tone Map Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Tone Map Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Tone Map Pass");
 		
 		postprocess_cbuf_data.tone_map_exposure = renderer_settings.tone_map_exposure;
@@ -3220,6 +3277,7 @@ namespace Case_Engine
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		ID3D11DeviceContext* context = command_context->GetNative();
 		CaseEngineGfxProfileCondScope(command_context, "FXAA Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("FXAA Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "FXAA Pass");
 
 		GfxShaderResourceRO srvs[1] = { fxaa_texture->SRV() };
@@ -3236,6 +3294,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "TAA Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("TAA Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "TAA Pass");
 
 		GfxShaderResourceRO srvs[] = { postprocess_textures[!postprocess_index]->SRV(), prev_hdr_render_target->SRV(), velocity_buffer->SRV() };
@@ -3253,6 +3312,7 @@ namespace Case_Engine
 	{
 		GfxCommandContext* command_context = gfx->GetCommandContext();
 		CaseEngineGfxProfileCondScope(command_context, "Sun Pass", profiling_enabled);
+		CaseEngineCpuProfileScope("Sun Pass");
 		CaseEngineGfxScopedAnnotation(command_context, "Sun Pass");
 
 		GfxRenderTarget rtv = sun_target->RTV();
@@ -3266,8 +3326,8 @@ namespace Case_Engine
 			auto [transform, mesh, material] = reg.get<Transform, Mesh, Material>(sun);
 			ShaderManager::GetShaderProgram(ShaderProgram::Sun)->Bind(command_context);
 
-			object_cbuf_data.model = transform.current_transform;
-			object_cbuf_data.transposed_inverse_model = object_cbuf_data.model.Invert();
+			object_cbuf_data.model = transform.world;
+			object_cbuf_data.transposed_inverse_model = transform.inverse_world;
 			object_cbuffer->Update(gfx->GetCommandContext(), object_cbuf_data);
 			material_cbuf_data.diffuse = material.diffuse;
 			material_cbuf_data.albedo_factor = material.albedo_factor;
@@ -18,6 +18,7 @@
 #include "Graphics/GfxProfiler.h"
 #include "Graphics/GfxBuffer.h"
 #include "tecs/Registry.h"
+#include "tecs/system_scheduler.h"
 
 
 // Namespace Case_Engine
@@ -69,6 +70,7 @@ namespace Case_Engine
 		GfxTexture const* GetOffscreenTexture() const;
 		PickingData GetLastPickingData() const;
 		std::vector<Timestamp> GetProfilerResults();
+		std::vector<tecs::system_timing> const& GetSystemTimings() const;
 
 	private:
 		uint32_t width, height;
@@ -84,6 +86,7 @@ namespace Case_Engine
 		Picker picker;
 		PickingData last_picking_data;
 		float current_dt = 0.0f;
+		tecs::system_scheduler update_systems;
 
 		//textures
 		std::vector<std::unique_ptr<GfxTexture>> gbuffer;
@@ -188,6 +191,9 @@ namespace Case_Engine
 		std::unique_ptr<GfxConstantBuffer<TerrainCBuffer>> terrain_cbuffer = nullptr;
 
 		std::unique_ptr<GfxBuffer> lights = nullptr;
+		tecs::tick_type lights_tick = 0;
+		tecs::tick_type transforms_tick = 0;
+		Matrix lights_view;
 		std::unique_ptr<GfxBuffer>	voxels = nullptr;
 		std::unique_ptr<GfxBuffer> clusters = nullptr;
 		std::unique_ptr<GfxBuffer>	light_counter = nullptr;
@@ -234,6 +240,7 @@ namespace Case_Engine
 		void CreateIBLTextures();
 
 		void BindGlobals();
+		void RegisterUpdateSystems();
 
 		void UpdateCBuffers(float dt);
 		void UpdateOcean(float dt);
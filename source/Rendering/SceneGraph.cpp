@@ -0,0 +1,143 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#include "SceneGraph.h"
+#include "Utilities/FrameArena.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace
+	{
+		Relationship& AssureRelationship(tecs::registry& reg, tecs::entity e)
+		{
+			if (!reg.has<Relationship>(e)) reg.emplace<Relationship>(e);
+			return reg.get<Relationship>(e);
+		}
+
+		void UpdateDepth(tecs::registry& reg, tecs::entity e, uint32_t depth)
+		{
+			reg.get<Relationship>(e).depth = depth;
+			ForEachChild(reg, e, [&](tecs::entity child) { UpdateDepth(reg, child, depth + 1); });
+		}
+	}
+
+	void AttachChild(tecs::registry& reg, tecs::entity parent, tecs::entity child)
+	{
+		CASE_ENGINE_ASSERT(parent != child);
+		DetachChild(reg, child);
+
+		Relationship& parent_relationship = AssureRelationship(reg, parent);
+		tecs::entity const next_sibling = parent_relationship.first_child;
+		uint32_t const depth = parent_relationship.depth + 1;
+		parent_relationship.first_child = child;
+
+		Relationship& child_relationship = AssureRelationship(reg, child);
+		child_relationship.parent = parent;
+		child_relationship.next_sibling = next_sibling;
+		UpdateDepth(reg, child, depth);
+	}
+
+	void AttachChildren(tecs::registry& reg, tecs::entity parent, std::span<tecs::entity const> children)
+	{
+		if (children.empty()) return;
+
+		Relationship& parent_relationship = AssureRelationship(reg, parent);
+		CASE_ENGINE_ASSERT(parent_relationship.first_child == tecs::null_entity);
+		parent_relationship.first_child = children.front();
+		uint32_t const depth = parent_relationship.depth + 1;
+
+		std::vector<Relationship> relationships(children.size(), Relationship{ parent, tecs::null_entity, tecs::null_entity, depth });
+		for (size_t i = 0; i + 1 < children.size(); ++i) relationships[i].next_sibling = children[i + 1];
+		reg.insert<Relationship>(children.begin(), children.end(), relationships.begin());
+	}
+
+	void DetachChild(tecs::registry& reg, tecs::entity child)
+	{
+		Relationship* child_relationship = reg.get_if<Relationship>(child);
+		if (!child_relationship || child_relationship->parent == tecs::null_entity) return;
+
+		tecs::entity const parent = child_relationship->parent;
+		tecs::entity const next_sibling = child_relationship->next_sibling;
+		child_relationship->parent = tecs::null_entity;
+		child_relationship->next_sibling = tecs::null_entity;
+
+		Relationship& parent_relationship = reg.get<Relationship>(parent);
+		if (parent_relationship.first_child == child) parent_relationship.first_child = next_sibling;
+		else
+		{
+			tecs::entity sibling = parent_relationship.first_child;
+			while (sibling != tecs::null_entity)
+			{
+				Relationship& sibling_relationship = reg.get<Relationship>(sibling);
+				if (sibling_relationship.next_sibling == child)
+				{
+					sibling_relationship.next_sibling = next_sibling;
+					break;
+				}
+				sibling = sibling_relationship.next_sibling;
+			}
+		}
+		UpdateDepth(reg, child, 0);
+		if (reg.has<Transform>(child)) reg.touch<Transform>(child);
+	}
+
+	void UpdateWorldTransforms(tecs::registry& reg, tecs::tick_type since)
+	{
+		auto transform_view = reg.view<Transform>();
+		auto relationship_view = reg.view<Relationship>();
+
+		//parents always precede their children in the relationship pool
+		auto SortByDepth = [&reg]()
+			{
+				reg.sort<Relationship>([](Relationship const& lhs, Relationship const& rhs) { return lhs.depth < rhs.depth; });
+			};
+		if (relationship_view.any_changed(since)) SortByDepth();
+
+		transform_view.each_changed(since, [&](tecs::entity e, Transform& transform)
+			{
+				if (relationship_view.contains(e) && relationship_view.get(e).parent != tecs::null_entity) return;
+				transform.world = transform.current_transform;
+				transform.inverse_world = transform.world.Invert();
+			});
+
+		FrameVector<uint8_t> dirty(relationship_view.size(), false);
+		bool resorted = false;
+		for (size_t i = 0; i < relationship_view.size(); ++i)
+		{
+			tecs::entity const e = relationship_view[i];
+			Relationship const& relationship = relationship_view.get(e);
+			bool const has_transform = transform_view.contains(e);
+
+			dirty[i] = relationship_view.changed(e, since) || (has_transform && transform_view.changed(e, since));
+			if (relationship.parent == tecs::null_entity) continue;
+
+			if (relationship_view.contains(relationship.parent))
+			{
+				//removals swap the last relationship into the freed slot without touching it, so the order can break unnoticed.
+				//sorting puts every parent first, starting over recomputes whatever was composed with a stale parent
+				size_t const parent_index = relationship_view.index(relationship.parent);
+				if (parent_index > i && !resorted)
+				{
+					SortByDepth();
+					resorted = true;
+					i = static_cast<size_t>(-1);
+					continue;
+				}
+				dirty[i] |= parent_index > i || dirty[parent_index];
+			}
+			else dirty[i] |= transform_view.contains(relationship.parent) && transform_view.changed(relationship.parent, since);
+
+			if (!dirty[i] || !has_transform) continue;
+
+			Transform& transform = transform_view.get(e);
+			Matrix const parent_world = transform_view.contains(relationship.parent) ? transform_view.get(relationship.parent).world : Matrix::Identity;
+			transform.world = transform.current_transform * parent_world;
+			transform.inverse_world = transform.world.Invert();
+		}
+	}
+}
\ No newline at end of file
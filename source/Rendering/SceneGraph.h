@@ -0,0 +1,36 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <span>
+#include "Components.h"
+#include "tecs/registry.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	void AttachChild(tecs::registry& reg, tecs::entity parent, tecs::entity child);
+	void AttachChildren(tecs::registry& reg, tecs::entity parent, std::span<tecs::entity const> children);
+	void DetachChild(tecs::registry& reg, tecs::entity child);
+
+	//recomputes Transform::world and Transform::inverse_world for transforms and subtrees changed since the given tick
+	void UpdateWorldTransforms(tecs::registry& reg, tecs::tick_type since);
+
+	template<typename F>
+	void ForEachChild(tecs::registry& reg, tecs::entity parent, F&& f)
+	{
+		Relationship const* relationship = reg.get_if<Relationship const>(parent);
+		tecs::entity child = relationship ? relationship->first_child : tecs::null_entity;
+		while (child != tecs::null_entity)
+		{
+			Relationship const* child_relationship = reg.get_if<Relationship const>(child);
+			tecs::entity next = child_relationship ? child_relationship->next_sibling : tecs::null_entity;
+			f(child);
+			child = next;
+		}
+	}
+}
\ No newline at end of file
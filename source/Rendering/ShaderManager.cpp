@@ -7,7 +7,6 @@
 #include <unordered_map>
 #include <memory>
 #include <string_view>
-#include <execution>
 #include <filesystem>
 #include "ShaderManager.h"
 #include "Core/Logger.h"
@@ -20,6 +19,7 @@
 #include "Utilities/HashMap.h"
 #include "Utilities/HashSet.h"
 #include "Utilities/FileWatcher.h"
+#include "Utilities/Parallel.h"
 
 
 // Filesystem
@@ -515,7 +515,7 @@ namespace Case_Engine
 			}
 		}
 
-		void CompileShader(ShaderId shader, bool first_compile = false)
+		bool CompileShaderBytecode(ShaderId shader, GfxShaderCompileOutput& output)
 		{
 			GfxShaderDesc input{ .entrypoint = GetEntryPoint(shader) };
 #if _DEBUG
@@ -527,11 +527,11 @@ namespace Case_Engine
 			input.stage = GetStage(shader);
 			input.macros = GetShaderMacros(shader);
 
-			GfxShaderCompileOutput output{};
-			bool result = GfxShaderCompiler::CompileShader(input, output);
-			if (!result) return;
-
-			switch (input.stage)
+			return GfxShaderCompiler::CompileShader(input, output);
+		}
+		void CreateShader(ShaderId shader, GfxShaderCompileOutput const& output, bool first_compile)
+		{
+			switch (GetStage(shader))
 			{
 			case GfxShaderStage::VS:
 				if(first_compile) vs_shader_map[shader] = std::make_unique<GfxVertexShader>(device, output.shader_bytecode);
@@ -563,6 +563,11 @@ namespace Case_Engine
 			dependent_files_map[shader].clear();
 			dependent_files_map[shader].insert(output.includes.begin(), output.includes.end());
 		}
+		void CompileShader(ShaderId shader, bool first_compile = false)
+		{
+			GfxShaderCompileOutput output{};
+			if (CompileShaderBytecode(shader, output)) CreateShader(shader, output, first_compile);
+		}
 		void CreateAllPrograms()
 		{
 			using UnderlyingType = std::underlying_type_t<ShaderId>;
@@ -664,14 +669,20 @@ namespace Case_Engine
 
 			std::vector<UnderlyingType> shaders(ShaderId_Count);
 			std::iota(std::begin(shaders), std::end(shaders), 0);
-			std::for_each(
-				std::execution::seq,
+			std::vector<GfxShaderCompileOutput> outputs(ShaderId_Count);
+			std::vector<uint8_t> compiled(ShaderId_Count, false);
+			ForEach(
+				execution::par,
 				std::begin(shaders),
 				std::end(shaders),
-				[](UnderlyingType s)
+				[&](UnderlyingType s)
 				{
-					CompileShader((ShaderId)s, true);
+					compiled[s] = CompileShaderBytecode((ShaderId)s, outputs[s]);
 				});
+			for (UnderlyingType s : shaders)
+			{
+				if (compiled[s]) CreateShader((ShaderId)s, outputs[s], true);
+			}
 			CreateAllPrograms();
 			CASE_ENGINE_LOG(INFO, "Compilation done in %f seconds!", t.ElapsedInSeconds());
 		}
@@ -5,7 +5,7 @@
 
 // Includes
 #pragma once
-#include "Core/CoreTypes.h"
+#include <cstddef>
 #include "Core/Defines.h"
 
 
@@ -5,22 +5,51 @@
 
 // Includes
 #pragma once
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <bit>
+#include <thread>
+#include <type_traits>
 
 
 // Namespace Case_Engine
 namespace Case_Engine
 {
 
+    //bounded lock-free MPMC ring, every cell carries a sequence number telling producers and consumers whose turn it is.
+    //Push spins while the queue is full, TryPush fails instead; WaitPop sleeps on an atomic wait until a push or Close
     template<typename T>
     class ConcurrentQueue
     {
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+
+            T* Value()
+            {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
     public:
 
-        ConcurrentQueue() = default;
-        ~ConcurrentQueue() = default;
+        explicit ConcurrentQueue(size_t capacity = 1024) : mask(std::bit_ceil((std::max)(capacity, size_t{ 2 })) - 1), cells(std::make_unique<Cell[]>(mask + 1))
+        {
+            for (size_t i = 0; i <= mask; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        ~ConcurrentQueue()
+        {
+            size_t const last = enqueue_pos.load(std::memory_order_relaxed);
+            for (size_t pos = dequeue_pos.load(std::memory_order_relaxed); pos != last; ++pos)
+            {
+                Cell& cell = cells[pos & mask];
+                if (cell.sequence.load(std::memory_order_relaxed) == pos + 1) cell.Value()->~T();
+            }
+        }
 
         ConcurrentQueue(ConcurrentQueue const&) = delete;
         ConcurrentQueue(ConcurrentQueue&&) = delete;
@@ -29,54 +58,196 @@ namespace Case_Engine
         ConcurrentQueue& operator=(ConcurrentQueue&&) = delete;
 
 
+        template<typename U> requires std::constructible_from<T, U&&>
+        bool TryPush(U&& value)
+        {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true)
+            {
+                cell = &cells[pos & mask];
+                size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0) return false;
+                else pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+
+            new (cell->storage) T(std::forward<U>(value));
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            NotifyWaiters();
+            return true;
+        }
+
         void Push(T const& value)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            queue.push(value);
-            condVar.notify_one();
+            while (!TryPush(value)) std::this_thread::yield();
         }
 
         void Push(T&& value)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            queue.push(std::forward<T>(value));
-            condVar.notify_one();
+            while (!TryPush(std::move(value))) std::this_thread::yield();
         }
 
-        void WaitPop(T& value)
+        //moves up to count values starting at first into the queue, returns how many were pushed
+        template<typename It>
+        size_t TryPushBatch(It first, size_t count)
         {
-            std::unique_lock<std::mutex> lock(mutex);
-            condVar.wait(lock, [this] {return !queue.empty(); });
-            value = std::move(queue.front());
-            queue.pop();
+            if (count == 0) return 0;
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            size_t claimed = 0;
+            while (true)
+            {
+                claimed = 0;
+                while (claimed < count && cells[(pos + claimed) & mask].sequence.load(std::memory_order_acquire) == pos + claimed) ++claimed;
+                if (claimed == 0)
+                {
+                    size_t const sequence = cells[pos & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos) < 0) return 0;
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+                else if (enqueue_pos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) break;
+            }
+
+            for (size_t i = 0; i < claimed; ++i, ++first)
+            {
+                Cell& cell = cells[(pos + i) & mask];
+                new (cell.storage) T(std::move(*first));
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            NotifyWaiters();
+            return claimed;
         }
 
         bool TryPop(T& value)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            if (queue.empty()) return false;
-
-            value = std::move(queue.front());
-            queue.pop();
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true)
+            {
+                cell = &cells[pos & mask];
+                size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t const diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0) return false;
+                else pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+
+            T* stored = cell->Value();
+            value = std::move(*stored);
+            stored->~T();
+            cell->sequence.store(pos + mask + 1, std::memory_order_release);
             return true;
         }
 
+        //pops up to max_count values into out, returns how many were popped
+        template<typename OutIt>
+        size_t TryPopBatch(OutIt out, size_t max_count)
+        {
+            if (max_count == 0) return 0;
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            size_t claimed = 0;
+            while (true)
+            {
+                claimed = 0;
+                while (claimed < max_count && cells[(pos + claimed) & mask].sequence.load(std::memory_order_acquire) == pos + claimed + 1) ++claimed;
+                if (claimed == 0)
+                {
+                    size_t const sequence = cells[pos & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) return 0;
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+                else if (dequeue_pos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed)) break;
+            }
+
+            for (size_t i = 0; i < claimed; ++i)
+            {
+                Cell& cell = cells[(pos + i) & mask];
+                T* stored = cell.Value();
+                *out = std::move(*stored);
+                ++out;
+                stored->~T();
+                cell.sequence.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            return claimed;
+        }
+
+        //blocks until a value is popped, returns false once the queue is closed and drained
+        bool WaitPop(T& value)
+        {
+            while (true)
+            {
+                if (TryPop(value)) return true;
+
+                uint32_t const signal = push_signal.load();
+                waiting.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (TryPop(value))
+                {
+                    waiting.fetch_sub(1);
+                    return true;
+                }
+                if (closed.load())
+                {
+                    waiting.fetch_sub(1);
+                    return false;
+                }
+                push_signal.wait(signal);
+                waiting.fetch_sub(1);
+            }
+        }
+
+        //wakes every WaitPop, they drain what is left and then return false
+        void Close()
+        {
+            closed.store(true);
+            push_signal.fetch_add(1);
+            push_signal.notify_all();
+        }
+
         bool Empty() const
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            return queue.empty();
+            return Size() == 0;
         }
 
+        //approximate while other threads are pushing or popping
         size_t Size() const
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            return queue.size();
+            size_t const head = dequeue_pos.load(std::memory_order_acquire);
+            size_t const tail = enqueue_pos.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        size_t Capacity() const
+        {
+            return mask + 1;
         }
 
     private:
-        std::queue<T> queue;
-        mutable std::mutex mutex;
-        std::condition_variable condVar;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> push_signal = 0;
+        std::atomic<uint32_t> waiting = 0;
+        std::atomic<bool> closed = false;
+        alignas(CACHE_LINE_SIZE) size_t const mask;
+        std::unique_ptr<Cell[]> cells;
+
+    private:
+        void NotifyWaiters()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting.load(std::memory_order_relaxed) > 0)
+            {
+                push_signal.fetch_add(1);
+                push_signal.notify_all();
+            }
+        }
     };
 
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 // Includes
 #pragma once
 #include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
 
 
 // Namespace fs
@@ -42,6 +45,16 @@ namespace Case_Engine
 		fs::path p(file_path);
 		return fs::last_write_time(p);
 	}
+	inline std::optional<std::vector<uint8_t>> ReadFileBytes(std::string const& file_path)
+	{
+		std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+		if (!file) return std::nullopt;
+
+		std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) return std::nullopt;
+		return bytes;
+	}
 	inline std::string GetExtension(std::string const& path)
 	{
 		fs::path p(path);
@@ -0,0 +1,67 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#include <bit>
+#include "FrameArena.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+
+	FrameArena::FrameArena() : frame(current_frame.load(std::memory_order_relaxed)), block(AllocateBlock(INITIAL_CAPACITY))
+	{
+		allocator.emplace(INITIAL_CAPACITY);
+	}
+
+	FrameArena& FrameArena::Local()
+	{
+		thread_local FrameArena arena;
+		return arena;
+	}
+
+	void FrameArena::NextFrame()
+	{
+		current_frame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void* FrameArena::Allocate(size_t size, size_t align)
+	{
+		if (uint64_t const frame_index = current_frame.load(std::memory_order_relaxed); frame != frame_index)
+		{
+			Reset();
+			frame = frame_index;
+		}
+
+		if (OffsetType const offset = allocator->Allocate(size, align); offset != INVALID_OFFSET) return block.get() + offset;
+
+		Block& overflow = overflow_blocks.emplace_back(AllocateBlock(size + align));
+		overflow_size += size + align;
+		return reinterpret_cast<void*>(Align(reinterpret_cast<uintptr_t>(overflow.get()), align));
+	}
+
+	void FrameArena::Reset()
+	{
+		if (overflow_size == 0)
+		{
+			allocator->Clear();
+			return;
+		}
+
+		OffsetType const capacity = std::bit_ceil(allocator->MaxSize() + overflow_size);
+		overflow_blocks.clear();
+		overflow_size = 0;
+		block = AllocateBlock(capacity);
+		allocator.emplace(capacity);
+	}
+
+	FrameArena::Block FrameArena::AllocateBlock(OffsetType size)
+	{
+		return Block(new (std::align_val_t{ BLOCK_ALIGNMENT }) std::byte[size]);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#pragma once
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <map>
+#include <new>
+#include "LinearAllocator.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	//per-thread bump arena for memory that lives until the end of the frame.
+	//a thread resets its own arena on its first allocation in a new frame, so NextFrame never touches another thread's memory.
+	//running out spills into separate blocks which are folded into one bigger block on the next reset
+	class FrameArena
+	{
+		static constexpr OffsetType INITIAL_CAPACITY = 1 << 20;
+		static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+		struct BlockDeleter
+		{
+			void operator()(std::byte* block) const
+			{
+				::operator delete[](block, std::align_val_t{ BLOCK_ALIGNMENT });
+			}
+		};
+		using Block = std::unique_ptr<std::byte[], BlockDeleter>;
+
+	public:
+		FrameArena(FrameArena const&) = delete;
+		FrameArena(FrameArena&&) = delete;
+		FrameArena& operator=(FrameArena const&) = delete;
+		FrameArena& operator=(FrameArena&&) = delete;
+		~FrameArena() = default;
+
+		static FrameArena& Local();
+		//called on the main thread once all of the frame's work is done
+		static void NextFrame();
+
+		void* Allocate(size_t size, size_t align);
+
+		OffsetType UsedSize() const
+		{
+			return allocator->UsedSize() + overflow_size;
+		}
+
+		OffsetType Capacity() const
+		{
+			return allocator->MaxSize();
+		}
+
+	private:
+		inline static std::atomic<uint64_t> current_frame = 0;
+
+		uint64_t frame = 0;
+		Block block;
+		std::optional<LinearAllocator> allocator;
+		std::vector<Block> overflow_blocks;
+		OffsetType overflow_size = 0;
+
+	private:
+		FrameArena();
+
+		void Reset();
+		static Block AllocateBlock(OffsetType size);
+	};
+
+	//stateless allocator over the calling thread's FrameArena, deallocation is a no-op
+	template<typename T>
+	class FrameAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameAllocator() = default;
+		template<typename U>
+		FrameAllocator(FrameAllocator<U> const&) noexcept {}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(FrameArena::Local().Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) noexcept {}
+
+		template<typename U>
+		bool operator==(FrameAllocator<U> const&) const noexcept
+		{
+			return true;
+		}
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+	template<typename K, typename V, typename Compare = std::less<K>>
+	using FrameMap = std::map<K, V, Compare, FrameAllocator<std::pair<K const, V>>>;
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Cpp/FastNoiseLite.h"
 #include "Image.h"
 #include "Random.h"
+#include "Parallel.h"
 
 
 // Namespace Case_Engine
@@ -69,23 +70,33 @@ namespace Case_Engine
 		noise.SetFrequency(desc.frequency);
 		hm.resize(desc.depth);
 
-		float max_height_achieved = std::numeric_limits<float>::min();
-		float min_height_achieved = std::numeric_limits<float>::max();
-
-		for (uint32_t z = 0; z < desc.depth; z++)
-		{
-			hm[z].resize(desc.width);
-			for (uint32_t x = 0; x < desc.width; x++)
+		using HeightRange = std::pair<float, float>;
+		HeightRange const initial_range{ std::numeric_limits<float>::max(), std::numeric_limits<float>::min() };
+		HeightRange const height_range = ParallelReduce(0, desc.depth, 8, initial_range,
+			[&](size_t first, size_t last, HeightRange range)
 			{
-				float xf = x * desc.noise_scale / desc.width;
-				float zf = z * desc.noise_scale / desc.depth;
+				for (size_t z = first; z < last; z++)
+				{
+					hm[z].resize(desc.width);
+					for (uint32_t x = 0; x < desc.width; x++)
+					{
+						float xf = x * desc.noise_scale / desc.width;
+						float zf = z * desc.noise_scale / desc.depth;
 
-				float height = noise.GetNoise(xf, zf) * desc.max_height;
-				if (height > max_height_achieved) max_height_achieved = height;
-				if (height < min_height_achieved) min_height_achieved = height;
-				hm[z][x] = height;
-			}
-		}
+						float height = noise.GetNoise(xf, zf) * desc.max_height;
+						if (height > range.second) range.second = height;
+						if (height < range.first) range.first = height;
+						hm[z][x] = height;
+					}
+				}
+				return range;
+			},
+			[](HeightRange lhs, HeightRange rhs)
+			{
+				return HeightRange{ std::min(lhs.first, rhs.first), std::max(lhs.second, rhs.second) };
+			});
+		float const min_height_achieved = height_range.first;
+		float const max_height_achieved = height_range.second;
 
 		auto scale = [=](float h) -> float
 		{
@@ -93,13 +104,13 @@ namespace Case_Engine
 				* 2 * desc.max_height - desc.max_height;
 		};
 
-		for (uint32_t z = 0; z < desc.depth; z++)
-		{
-			for (uint32_t x = 0; x < desc.width; x++)
+		ParallelFor(0, desc.depth, 8, [&](size_t z)
 			{
-				hm[z][x] = scale(hm[z][x]);
-			}
-		}
+				for (uint32_t x = 0; x < desc.width; x++)
+				{
+					hm[z][x] = scale(hm[z][x]);
+				}
+			});
 	}
 	Heightmap::Heightmap(std::string_view heightmap_path, uint32_t max_height)
 	{
@@ -0,0 +1,160 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#include <charconv>
+#include <cctype>
+#include "NameTable.h"
+#include "HashUtil.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace
+	{
+		//calls f(prefix, suffix) for every split of name that Generate could have produced, until f returns true
+		template<typename F>
+		void ForEachNumberedSplit(std::string_view name, F&& f)
+		{
+			size_t digits = 0;
+			while (digits < name.size() && std::isdigit(static_cast<unsigned char>(name[name.size() - digits - 1]))) ++digits;
+
+			for (size_t count = 1; count <= digits; ++count)
+			{
+				std::string_view const number = name.substr(name.size() - count);
+				if (count > 1 && number.front() == '0') continue;
+
+				uint64_t suffix = 0;
+				auto const [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), suffix);
+				if (ec != std::errc{}) return;
+				if (f(name.substr(0, name.size() - count), suffix)) return;
+			}
+		}
+	}
+
+	NameTable::NameTable()
+	{
+		InternLocked("default");
+	}
+
+	NameId NameTable::Intern(std::string_view name)
+	{
+		std::scoped_lock lock(name_mutex);
+		return InternLocked(name);
+	}
+
+	NameId NameTable::Generate(std::string_view prefix, uint64_t suffix)
+	{
+		std::scoped_lock lock(name_mutex);
+		NameId const prefix_id = InternLocked(prefix);
+		GeneratedKey const key{ prefix_id, suffix };
+		if (auto it = generated_ids.find(key); it != generated_ids.end()) return it->second;
+
+		//prefixes are always looked up by text, even when they are generated names themselves
+		std::string_view const prefix_text = FormatLocked(prefix_id);
+		name_ids.try_emplace(prefix_text, prefix_id);
+
+		//the same text may already exist as an interned name or as a generated name split at another digit
+		bool const ends_with_digit = !prefix_text.empty() && std::isdigit(static_cast<unsigned char>(prefix_text.back()));
+		if (ends_with_digit || numbered_prefixes.contains(prefix_text))
+		{
+			std::string const text = std::string(prefix_text) + std::to_string(suffix);
+			if (NameId const existing = FindLocked(text); existing != INVALID_NAME_ID)
+			{
+				generated_ids[key] = existing;
+				return existing;
+			}
+		}
+
+		NameId const id = static_cast<NameId>(entries.size());
+		entries.push_back(NameEntry{ .prefix = prefix_id, .suffix = suffix, .formatted = false });
+		generated_ids[key] = id;
+
+		for (size_t count = 1; count <= prefix_text.size() && std::isdigit(static_cast<unsigned char>(prefix_text[prefix_text.size() - count])); ++count)
+		{
+			if (prefix_text[prefix_text.size() - count] != '0') numbered_prefixes.insert(prefix_text.substr(0, prefix_text.size() - count));
+		}
+		return id;
+	}
+
+	NameId NameTable::Find(std::string_view name) const
+	{
+		std::scoped_lock lock(name_mutex);
+		return FindLocked(name);
+	}
+
+	char const* NameTable::CStr(NameId id)
+	{
+		std::scoped_lock lock(name_mutex);
+		if (id >= entries.size()) id = DEFAULT_NAME_ID;
+		return FormatLocked(id).data();
+	}
+
+	size_t NameTable::Size() const
+	{
+		std::scoped_lock lock(name_mutex);
+		return entries.size();
+	}
+
+	NameId NameTable::InternLocked(std::string_view name)
+	{
+		if (NameId const id = FindLocked(name); id != INVALID_NAME_ID) return id;
+
+		NameId const id = static_cast<NameId>(entries.size());
+		entries.push_back(NameEntry{ .text = std::string(name) });
+		std::string_view const text = entries.back().text;
+		name_ids.emplace(text, id);
+		ForEachNumberedSplit(text, [this](std::string_view prefix, uint64_t)
+			{
+				numbered_prefixes.insert(prefix);
+				return false;
+			});
+		return id;
+	}
+
+	std::string_view NameTable::FormatLocked(NameId id)
+	{
+		NameEntry& entry = entries[id];
+		if (!entry.formatted)
+		{
+			entry.text = FormatLocked(entry.prefix);
+			entry.text += std::to_string(entry.suffix);
+			entry.formatted = true;
+		}
+		return entry.text;
+	}
+
+	NameId NameTable::FindLocked(std::string_view name) const
+	{
+		if (auto it = name_ids.find(name); it != name_ids.end()) return it->second;
+		return FindGeneratedLocked(name);
+	}
+
+	NameId NameTable::FindGeneratedLocked(std::string_view name) const
+	{
+		NameId id = INVALID_NAME_ID;
+		ForEachNumberedSplit(name, [&](std::string_view prefix, uint64_t suffix)
+			{
+				auto prefix_it = name_ids.find(prefix);
+				if (prefix_it == name_ids.end()) return false;
+
+				auto it = generated_ids.find(GeneratedKey{ prefix_it->second, suffix });
+				if (it == generated_ids.end()) return false;
+				id = it->second;
+				return true;
+			});
+		return id;
+	}
+
+	size_t NameTable::GeneratedKeyHash::operator()(GeneratedKey const& key) const
+	{
+		size_t seed = 0;
+		HashCombine(seed, key.first);
+		HashCombine(seed, key.second);
+		return seed;
+	}
+
+}
\ No newline at end of file
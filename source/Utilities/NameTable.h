@@ -0,0 +1,68 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <string>
+#include <string_view>
+#include <deque>
+#include <mutex>
+#include "Singleton.h"
+#include "HashMap.h"
+#include "HashSet.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	using NameId = uint32_t;
+	inline constexpr NameId DEFAULT_NAME_ID = 0;
+	inline constexpr NameId INVALID_NAME_ID = static_cast<NameId>(-1);
+
+	//interns names into 32-bit ids that stay valid for the lifetime of the process,
+	//generated names (prefix + number) are kept as a pair and only formatted when first read.
+	//a text maps to one id no matter whether it was interned or generated, and through which prefix
+	class NameTable : public Singleton<NameTable>
+	{
+		friend class Singleton<NameTable>;
+
+		struct NameEntry
+		{
+			std::string text;
+			NameId prefix = DEFAULT_NAME_ID;
+			uint64_t suffix = 0;
+			bool formatted = true;
+		};
+
+		using GeneratedKey = std::pair<NameId, uint64_t>;
+		struct GeneratedKeyHash
+		{
+			size_t operator()(GeneratedKey const& key) const;
+		};
+
+	public:
+		NameId Intern(std::string_view name);
+		NameId Generate(std::string_view prefix, uint64_t suffix);
+		NameId Find(std::string_view name) const;
+		char const* CStr(NameId id);
+		size_t Size() const;
+
+	private:
+		std::deque<NameEntry> entries;
+		HashMap<std::string_view, NameId> name_ids;
+		std::unordered_map<GeneratedKey, NameId, GeneratedKeyHash> generated_ids;
+		HashSet<std::string_view> numbered_prefixes; //prefixes that some existing text continues with a number
+		mutable std::mutex name_mutex;
+
+	private:
+		NameTable();
+
+		NameId InternLocked(std::string_view name);
+		std::string_view FormatLocked(NameId id);
+		NameId FindLocked(std::string_view name) const;
+		NameId FindGeneratedLocked(std::string_view name) const;
+	};
+	#define g_NameTable NameTable::Get()
+}
\ No newline at end of file
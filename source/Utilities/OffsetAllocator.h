@@ -0,0 +1,329 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include "AllocatorUtil.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	struct OffsetAllocation
+	{
+		static constexpr uint32_t NO_SPACE = static_cast<uint32_t>(-1);
+
+		OffsetType offset = INVALID_OFFSET;
+		uint32_t metadata = NO_SPACE;
+
+		bool Valid() const { return offset != INVALID_OFFSET; }
+	};
+
+	struct OffsetAllocatorStats
+	{
+		OffsetType used_size = 0;
+		OffsetType free_size = 0;
+		OffsetType largest_free_region = 0;
+		uint32_t allocation_count = 0;
+		uint32_t free_region_count = 0;
+
+		//0 when all free space is one region, approaches 1 as it gets scattered into small holes
+		float Fragmentation() const
+		{
+			return free_size ? 1.0f - float(largest_free_region) / float(free_size) : 0.0f;
+		}
+	};
+
+	//two level segregated fit over an offset range, allocation and free are O(1).
+	//sizes are binned into a small float (5 bit exponent, 3 bit mantissa), free neighbours are merged on free
+	class OffsetAllocator
+	{
+		static constexpr uint32_t MANTISSA_BITS = 3;
+		static constexpr uint32_t MANTISSA_VALUE = 1 << MANTISSA_BITS;
+		static constexpr uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+		static constexpr uint32_t TOP_BIN_COUNT = 32;
+		static constexpr uint32_t LEAF_BIN_COUNT = 8;
+		static constexpr uint32_t BIN_COUNT = TOP_BIN_COUNT * LEAF_BIN_COUNT;
+		static constexpr uint32_t UNUSED = static_cast<uint32_t>(-1);
+
+		struct Node
+		{
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			uint32_t bin_list_prev = UNUSED;
+			uint32_t bin_list_next = UNUSED;
+			uint32_t neighbor_prev = UNUSED;
+			uint32_t neighbor_next = UNUSED;
+			bool used = false;
+		};
+
+	public:
+
+		OffsetAllocator(OffsetType max_size, uint32_t max_allocations = 128 * 1024) :
+			max_size{ static_cast<uint32_t>(max_size) }, max_allocations{ max_allocations }
+		{
+			assert(max_size <= UINT32_MAX && max_allocations > 0);
+			Clear();
+		}
+		OffsetAllocator(OffsetAllocator const&) = delete;
+		OffsetAllocator& operator=(OffsetAllocator const&) = delete;
+		OffsetAllocator(OffsetAllocator&&) = default;
+		OffsetAllocator& operator=(OffsetAllocator&&) = default;
+		~OffsetAllocator() = default;
+
+		OffsetAllocation Allocate(OffsetType size, OffsetType align = 0)
+		{
+			if (size == 0 || size > max_size) return {};
+			//a padded allocation can split its node in three
+			if (free_node_count < 2) return {};
+
+			OffsetType const padding = (align > 1 && !(align & (align - 1))) ? align - 1 : 0;
+			if (size + padding > max_size) return {};
+
+			uint32_t const min_bin = SizeToBinRoundUp(static_cast<uint32_t>(size + padding));
+			uint32_t const min_top = min_bin >> MANTISSA_BITS;
+			uint32_t const min_leaf = min_bin & MANTISSA_MASK;
+
+			uint32_t top = min_top;
+			uint32_t leaf = UNUSED;
+			if (used_bins_top & (1u << top)) leaf = LowestSetBitAfter(used_bins[top], min_leaf);
+			if (leaf == UNUSED)
+			{
+				top = LowestSetBitAfter(used_bins_top, min_top + 1);
+				if (top == UNUSED) return {};
+				leaf = static_cast<uint32_t>(std::countr_zero(used_bins[top]));
+			}
+
+			uint32_t const bin = (top << MANTISSA_BITS) | leaf;
+			uint32_t const node_index = bin_heads[bin];
+			RemoveNodeFromBin(node_index);
+
+			Node& node = nodes[node_index];
+			node.used = true;
+			++allocation_count;
+
+			uint32_t const aligned_offset = static_cast<uint32_t>(Align(node.offset, align));
+			if (uint32_t const pad = aligned_offset - node.offset; pad > 0)
+			{
+				uint32_t const pad_index = InsertNodeIntoBin(node.offset, pad);
+				LinkNeighbors(nodes[node_index].neighbor_prev, pad_index, node_index);
+				nodes[node_index].offset = aligned_offset;
+				nodes[node_index].size -= pad;
+			}
+
+			if (uint32_t const remainder = nodes[node_index].size - static_cast<uint32_t>(size); remainder > 0)
+			{
+				uint32_t const remainder_index = InsertNodeIntoBin(nodes[node_index].offset + static_cast<uint32_t>(size), remainder);
+				LinkNeighbors(node_index, remainder_index, nodes[node_index].neighbor_next);
+				nodes[node_index].size = static_cast<uint32_t>(size);
+			}
+
+			return OffsetAllocation{ .offset = nodes[node_index].offset, .metadata = node_index };
+		}
+
+		void Free(OffsetAllocation allocation)
+		{
+			if (!allocation.Valid()) return;
+			uint32_t node_index = allocation.metadata;
+			assert(node_index < nodes.size() && nodes[node_index].used);
+
+			Node& node = nodes[node_index];
+			uint32_t offset = node.offset;
+			uint32_t size = node.size;
+			--allocation_count;
+
+			if (node.neighbor_prev != UNUSED && !nodes[node.neighbor_prev].used)
+			{
+				Node const& prev = nodes[node.neighbor_prev];
+				offset = prev.offset;
+				size += prev.size;
+
+				uint32_t const prev_index = node.neighbor_prev;
+				RemoveNodeFromBin(prev_index);
+				node.neighbor_prev = nodes[prev_index].neighbor_prev;
+				ReleaseNode(prev_index);
+			}
+			if (node.neighbor_next != UNUSED && !nodes[node.neighbor_next].used)
+			{
+				Node const& next = nodes[node.neighbor_next];
+				size += next.size;
+
+				uint32_t const next_index = node.neighbor_next;
+				RemoveNodeFromBin(next_index);
+				node.neighbor_next = nodes[next_index].neighbor_next;
+				ReleaseNode(next_index);
+			}
+
+			uint32_t const neighbor_prev = node.neighbor_prev;
+			uint32_t const neighbor_next = node.neighbor_next;
+			ReleaseNode(node_index);
+
+			uint32_t const merged_index = InsertNodeIntoBin(offset, size);
+			LinkNeighbors(neighbor_prev, merged_index, neighbor_next);
+		}
+
+		void Clear()
+		{
+			nodes.assign(max_allocations + 1, Node{});
+			free_nodes.resize(max_allocations + 1);
+			for (uint32_t i = 0; i < free_nodes.size(); ++i) free_nodes[i] = max_allocations - i;
+			free_node_count = max_allocations + 1;
+
+			used_bins_top = 0;
+			for (auto& used_bin : used_bins) used_bin = 0;
+			for (auto& bin_head : bin_heads) bin_head = UNUSED;
+			free_size = 0;
+			allocation_count = 0;
+
+			if (max_size > 0) InsertNodeIntoBin(0, max_size);
+		}
+
+		OffsetType AllocationSize(OffsetAllocation allocation) const
+		{
+			return allocation.Valid() ? nodes[allocation.metadata].size : 0;
+		}
+
+		//exact size of the biggest hole, walks a single bin
+		OffsetType LargestFreeRegion() const
+		{
+			if (!used_bins_top) return 0;
+			uint32_t const top = 31 - static_cast<uint32_t>(std::countl_zero(used_bins_top));
+			uint32_t const leaf = 31 - static_cast<uint32_t>(std::countl_zero(static_cast<uint32_t>(used_bins[top])));
+
+			uint32_t largest = 0;
+			for (uint32_t i = bin_heads[(top << MANTISSA_BITS) | leaf]; i != UNUSED; i = nodes[i].bin_list_next)
+				largest = std::max(largest, nodes[i].size);
+			return largest;
+		}
+
+		//walks all nodes, meant for tooling rather than per allocation
+		OffsetAllocatorStats Stats() const
+		{
+			OffsetAllocatorStats stats{};
+			stats.used_size = UsedSize();
+			stats.free_size = free_size;
+			stats.largest_free_region = LargestFreeRegion();
+			stats.allocation_count = allocation_count;
+			for (uint32_t head : bin_heads)
+				for (uint32_t i = head; i != UNUSED; i = nodes[i].bin_list_next) ++stats.free_region_count;
+			return stats;
+		}
+
+		OffsetType MaxSize()  const { return max_size; }
+		OffsetType FreeSize() const { return free_size; }
+		OffsetType UsedSize() const { return max_size - free_size; }
+		uint32_t AllocationCount() const { return allocation_count; }
+		bool Empty()		  const { return allocation_count == 0; }
+		bool Full()			  const { return free_size == 0; }
+
+	private:
+		uint32_t max_size;
+		uint32_t max_allocations;
+		uint32_t free_size = 0;
+		uint32_t allocation_count = 0;
+
+		uint32_t used_bins_top = 0;
+		uint8_t used_bins[TOP_BIN_COUNT]{};
+		uint32_t bin_heads[BIN_COUNT]{};
+
+		std::vector<Node> nodes;
+		std::vector<uint32_t> free_nodes;
+		uint32_t free_node_count = 0;
+
+	private:
+
+		static uint32_t SizeToBin(uint32_t size, bool round_up)
+		{
+			if (size < MANTISSA_VALUE) return size;
+
+			uint32_t const highest_bit = 31 - static_cast<uint32_t>(std::countl_zero(size));
+			uint32_t const mantissa_start = highest_bit - MANTISSA_BITS;
+			uint32_t const exponent = mantissa_start + 1;
+			uint32_t mantissa = (size >> mantissa_start) & MANTISSA_MASK;
+			if (round_up && (size & ((1u << mantissa_start) - 1))) ++mantissa;
+
+			//mantissa overflow carries into the exponent
+			return (exponent << MANTISSA_BITS) + mantissa;
+		}
+		static uint32_t SizeToBinRoundUp(uint32_t size)   { return SizeToBin(size, true); }
+		static uint32_t SizeToBinRoundDown(uint32_t size) { return SizeToBin(size, false); }
+
+		static uint32_t LowestSetBitAfter(uint32_t mask, uint32_t start)
+		{
+			if (start >= 32) return UNUSED;
+			uint32_t const masked = mask & ~((1u << start) - 1);
+			return masked ? static_cast<uint32_t>(std::countr_zero(masked)) : UNUSED;
+		}
+
+		uint32_t InsertNodeIntoBin(uint32_t offset, uint32_t size)
+		{
+			uint32_t const bin = SizeToBinRoundDown(size);
+			uint32_t const top = bin >> MANTISSA_BITS;
+			uint32_t const leaf = bin & MANTISSA_MASK;
+
+			if (bin_heads[bin] == UNUSED)
+			{
+				used_bins[top] |= 1u << leaf;
+				used_bins_top |= 1u << top;
+			}
+
+			assert(free_node_count > 0);
+			uint32_t const node_index = free_nodes[--free_node_count];
+			nodes[node_index] = Node{ .offset = offset, .size = size, .bin_list_next = bin_heads[bin] };
+			if (bin_heads[bin] != UNUSED) nodes[bin_heads[bin]].bin_list_prev = node_index;
+			bin_heads[bin] = node_index;
+
+			free_size += size;
+			return node_index;
+		}
+
+		void RemoveNodeFromBin(uint32_t node_index)
+		{
+			Node& node = nodes[node_index];
+			free_size -= node.size;
+			if (node.bin_list_prev != UNUSED)
+			{
+				nodes[node.bin_list_prev].bin_list_next = node.bin_list_next;
+				if (node.bin_list_next != UNUSED) nodes[node.bin_list_next].bin_list_prev = node.bin_list_prev;
+			}
+			else
+			{
+				uint32_t const bin = SizeToBinRoundDown(node.size);
+				uint32_t const top = bin >> MANTISSA_BITS;
+				uint32_t const leaf = bin & MANTISSA_MASK;
+
+				bin_heads[bin] = node.bin_list_next;
+				if (node.bin_list_next != UNUSED) nodes[node.bin_list_next].bin_list_prev = UNUSED;
+				else
+				{
+					used_bins[top] &= ~(1u << leaf);
+					if (!used_bins[top]) used_bins_top &= ~(1u << top);
+				}
+			}
+			node.bin_list_prev = UNUSED;
+			node.bin_list_next = UNUSED;
+		}
+
+		void ReleaseNode(uint32_t node_index)
+		{
+			nodes[node_index] = Node{};
+			free_nodes[free_node_count++] = node_index;
+		}
+
+		void LinkNeighbors(uint32_t prev, uint32_t node_index, uint32_t next)
+		{
+			nodes[node_index].neighbor_prev = prev;
+			nodes[node_index].neighbor_next = next;
+			if (prev != UNUSED) nodes[prev].neighbor_next = node_index;
+			if (next != UNUSED) nodes[next].neighbor_prev = node_index;
+		}
+	};
+
+}
\ No newline at end of file
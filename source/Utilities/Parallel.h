@@ -0,0 +1,112 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <atomic>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "ThreadPool.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace impl
+	{
+		inline constexpr size_t MAX_REDUCE_CHUNKS = 256;
+
+		template<typename F>
+		void InvokeRange(F& f, size_t first, size_t last)
+		{
+			if constexpr (std::is_invocable_v<F&, size_t, size_t>) f(first, last);
+			else for (size_t i = first; i < last; ++i) f(i);
+		}
+	}
+
+	//runs f(i) or f(first, last) over [begin, end) on the calling thread and g_ThreadPool, never splitting below grain.
+	//participants claim shrinking chunks from a shared cursor, so uneven iterations balance themselves
+	template<typename F>
+	void ParallelFor(size_t begin, size_t end, size_t grain, F&& f)
+	{
+		if (begin >= end) return;
+		grain = (std::max)(grain, size_t{ 1 });
+		size_t const count = end - begin;
+		size_t const helpers = (std::min)(static_cast<size_t>(g_ThreadPool.NumThreads()), (count - 1) / grain);
+		if (helpers == 0)
+		{
+			impl::InvokeRange(f, begin, end);
+			return;
+		}
+
+		size_t const participants = helpers + 1;
+		std::atomic<size_t> cursor = begin;
+		auto Work = [&]()
+			{
+				size_t first = cursor.load(std::memory_order_relaxed);
+				while (first < end)
+				{
+					size_t const remaining = end - first;
+					size_t const size = (std::min)(remaining, (std::max)(grain, remaining / (2 * participants)));
+					if (cursor.compare_exchange_weak(first, first + size, std::memory_order_relaxed))
+					{
+						impl::InvokeRange(f, first, first + size);
+						first = cursor.load(std::memory_order_relaxed);
+					}
+				}
+			};
+
+		JobCounter counter;
+		for (size_t i = 0; i < helpers; ++i) g_ThreadPool.Schedule(counter, Work);
+		Work();
+		g_ThreadPool.Wait(counter);
+	}
+
+	//f(first, last, partial) -> T folds one chunk, partials are combined in chunk order with reduce(lhs, rhs) -> T.
+	//chunks depend only on the range and grain, so the result is the same for any number of threads
+	template<typename T, typename F, typename R>
+	T ParallelReduce(size_t begin, size_t end, size_t grain, T identity, F&& f, R&& reduce)
+	{
+		if (begin >= end) return identity;
+		size_t const count = end - begin;
+		size_t const chunk_size = (std::max)({ grain, size_t{ 1 }, (count + impl::MAX_REDUCE_CHUNKS - 1) / impl::MAX_REDUCE_CHUNKS });
+		size_t const chunk_count = (count + chunk_size - 1) / chunk_size;
+
+		std::vector<T> partials(chunk_count, identity);
+		ParallelFor(0, chunk_count, 1, [&](size_t chunk)
+			{
+				size_t const first = begin + chunk * chunk_size;
+				partials[chunk] = f(first, (std::min)(first + chunk_size, end), std::move(partials[chunk]));
+			});
+		for (T& partial : partials) identity = reduce(std::move(identity), std::move(partial));
+		return identity;
+	}
+
+	namespace execution
+	{
+		struct SequencedPolicy {};
+		struct ParallelPolicy
+		{
+			size_t grain = 1;
+		};
+
+		inline constexpr SequencedPolicy seq{};
+		inline constexpr ParallelPolicy par{};
+	}
+
+	template<std::random_access_iterator It, typename F>
+	void ForEach(execution::SequencedPolicy, It first, It last, F&& f)
+	{
+		std::for_each(first, last, f);
+	}
+
+	template<std::random_access_iterator It, typename F>
+	void ForEach(execution::ParallelPolicy policy, It first, It last, F&& f)
+	{
+		ParallelFor(0, static_cast<size_t>(std::distance(first, last)), policy.grain, [&](size_t i) { f(first[i]); });
+	}
+}
\ No newline at end of file
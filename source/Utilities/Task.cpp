@@ -0,0 +1,59 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#include "Task.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+
+	void TaskScheduler::Initialize()
+	{
+		main_thread_id = std::this_thread::get_id();
+	}
+
+	void TaskScheduler::PostToMainThread(std::coroutine_handle<> continuation)
+	{
+		std::scoped_lock lock(continuations_mutex);
+		continuations.push_back(continuation);
+	}
+
+	void TaskScheduler::RunMainThreadContinuations()
+	{
+		assert(IsMainThread());
+		std::vector<std::coroutine_handle<>> ready;
+		{
+			std::scoped_lock lock(continuations_mutex);
+			ready.swap(continuations);
+		}
+		for (std::coroutine_handle<> continuation : ready) continuation.resume();
+	}
+
+	bool TaskScheduler::HelpOne()
+	{
+		if (IsMainThread())
+		{
+			std::coroutine_handle<> continuation = nullptr;
+			{
+				std::scoped_lock lock(continuations_mutex);
+				if (!continuations.empty())
+				{
+					continuation = continuations.front();
+					continuations.erase(continuations.begin());
+				}
+			}
+			if (continuation)
+			{
+				continuation.resume();
+				return true;
+			}
+		}
+		return g_ThreadPool.ExecuteOne(JobPriority::Background);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#pragma once
+#include <coroutine>
+#include <atomic>
+#include <optional>
+#include <exception>
+#include <utility>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <cassert>
+#include "ThreadPool.h"
+#include "FilesUtil.h"
+#include "Singleton.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	//owns the continuations that have to run on the main thread, they are resumed at the start of every frame
+	class TaskScheduler : public Singleton<TaskScheduler>
+	{
+		friend class Singleton<TaskScheduler>;
+
+	public:
+		void Initialize();
+
+		bool IsMainThread() const
+		{
+			return std::this_thread::get_id() == main_thread_id;
+		}
+
+		void PostToMainThread(std::coroutine_handle<> continuation);
+		void RunMainThreadContinuations();
+
+		//runs one pending continuation or job, returns false if there was nothing to do
+		bool HelpOne();
+
+	private:
+		std::thread::id main_thread_id = std::this_thread::get_id();
+		std::mutex continuations_mutex;
+		std::vector<std::coroutine_handle<>> continuations;
+
+	private:
+		TaskScheduler() = default;
+	};
+	#define g_TaskScheduler TaskScheduler::Get()
+
+	template<typename T>
+	class Task;
+
+	namespace impl
+	{
+		enum class TaskState : uint8_t
+		{
+			Created,
+			Running,
+			Finished,
+			Detached
+		};
+
+		class TaskPromiseBase
+		{
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				template<typename P>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept
+				{
+					TaskPromiseBase& promise = handle.promise();
+					std::coroutine_handle<> continuation = promise.continuation;
+					if (promise.state.exchange(TaskState::Finished) == TaskState::Detached)
+					{
+						handle.destroy();
+						return std::noop_coroutine();
+					}
+					return continuation ? continuation : std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept {}
+			};
+
+		public:
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			FinalAwaiter final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void unhandled_exception()
+			{
+				exception = std::current_exception();
+			}
+
+			std::coroutine_handle<> continuation;
+			std::atomic<TaskState> state = TaskState::Created;
+			std::exception_ptr exception;
+		};
+
+		template<typename T>
+		class TaskPromise : public TaskPromiseBase
+		{
+		public:
+			Task<T> get_return_object() noexcept;
+
+			template<typename U> requires std::is_convertible_v<U&&, T>
+			void return_value(U&& value)
+			{
+				result.emplace(std::forward<U>(value));
+			}
+
+			T Result()
+			{
+				if (exception) std::rethrow_exception(exception);
+				return std::move(*result);
+			}
+
+		private:
+			std::optional<T> result;
+		};
+
+		template<>
+		class TaskPromise<void> : public TaskPromiseBase
+		{
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() const noexcept {}
+
+			void Result()
+			{
+				if (exception) std::rethrow_exception(exception);
+			}
+		};
+	}
+
+	//lazily started coroutine: it runs when it is awaited, started or detached.
+	//the thread it continues on is picked with co_await ResumeOnWorker(), ResumeOnMainThread() or ReadFileAsync()
+	template<typename T = void>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = impl::TaskPromise<T>;
+		using handle_type = std::coroutine_handle<promise_type>;
+
+		Task() = default;
+		explicit Task(handle_type handle) : handle(handle) {}
+		Task(Task const&) = delete;
+		Task& operator=(Task const&) = delete;
+		Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		}
+		~Task()
+		{
+			Reset();
+		}
+
+		bool Valid() const
+		{
+			return static_cast<bool>(handle);
+		}
+
+		bool Done() const
+		{
+			return handle && handle.promise().state.load() == impl::TaskState::Finished;
+		}
+
+		void Start()
+		{
+			assert(handle);
+			impl::TaskState expected = impl::TaskState::Created;
+			if (handle.promise().state.compare_exchange_strong(expected, impl::TaskState::Running)) handle.resume();
+		}
+
+		//lets the task run to completion on its own, the frame is freed by whichever side finishes last
+		void Detach()
+		{
+			if (!handle) return;
+			Start();
+			if (handle.promise().state.exchange(impl::TaskState::Detached) == impl::TaskState::Finished) handle.destroy();
+			handle = nullptr;
+		}
+
+		//blocks until the task finishes, running jobs and main thread continuations meanwhile
+		T Get()
+		{
+			Start();
+			while (!Done())
+			{
+				if (!g_TaskScheduler.HelpOne()) std::this_thread::yield();
+			}
+			return handle.promise().Result();
+		}
+
+		auto operator co_await() noexcept
+		{
+			struct Awaiter
+			{
+				handle_type handle;
+
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().continuation = awaiting;
+					impl::TaskState expected = impl::TaskState::Created;
+					if (handle.promise().state.compare_exchange_strong(expected, impl::TaskState::Running)) return handle;
+					assert(expected != impl::TaskState::Running && "awaiting a task that is already running");
+					return awaiting;
+				}
+
+				T await_resume()
+				{
+					return handle.promise().Result();
+				}
+			};
+			assert(handle);
+			return Awaiter{ handle };
+		}
+
+	private:
+		handle_type handle = nullptr;
+
+	private:
+		void Reset()
+		{
+			if (!handle) return;
+			assert(handle.promise().state.load() != impl::TaskState::Running && "task destroyed while running, detach it instead");
+			handle.destroy();
+			handle = nullptr;
+		}
+	};
+
+	namespace impl
+	{
+		template<typename T>
+		Task<T> TaskPromise<T>::get_return_object() noexcept
+		{
+			return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+		}
+
+		inline Task<void> TaskPromise<void>::get_return_object() noexcept
+		{
+			return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+		}
+	}
+
+	//continues the awaiting coroutine on a g_ThreadPool worker
+	inline auto ResumeOnWorker(JobPriority priority = JobPriority::Normal)
+	{
+		struct Awaiter
+		{
+			JobPriority priority;
+
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> continuation) const
+			{
+				g_ThreadPool.Dispatch([continuation]() { continuation.resume(); }, priority);
+			}
+
+			void await_resume() const noexcept {}
+		};
+		return Awaiter{ priority };
+	}
+
+	//continues the awaiting coroutine at the start of the next frame, or right away if it already runs on the main thread
+	inline auto ResumeOnMainThread()
+	{
+		struct Awaiter
+		{
+			bool await_ready() const noexcept
+			{
+				return g_TaskScheduler.IsMainThread();
+			}
+
+			void await_suspend(std::coroutine_handle<> continuation) const
+			{
+				g_TaskScheduler.PostToMainThread(continuation);
+			}
+
+			void await_resume() const noexcept {}
+		};
+		return Awaiter{};
+	}
+
+	//reads the whole file on an io thread and continues on a worker of the given lane, std::nullopt if the file could not be read
+	inline auto ReadFileAsync(std::string path, JobPriority priority = JobPriority::Background)
+	{
+		struct Awaiter
+		{
+			std::string path;
+			JobPriority priority;
+			std::optional<std::vector<uint8_t>> data;
+
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> continuation)
+			{
+				g_ThreadPool.DispatchIO([this, continuation]()
+					{
+						data = ReadFileBytes(path);
+						g_ThreadPool.Dispatch([continuation]() { continuation.resume(); }, priority);
+					});
+			}
+
+			std::optional<std::vector<uint8_t>> await_resume()
+			{
+				return std::move(data);
+			}
+		};
+		return Awaiter{ std::move(path), priority };
+	}
+}
\ No newline at end of file
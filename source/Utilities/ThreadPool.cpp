@@ -0,0 +1,233 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+
+// Includes
+#include "Windows.h"
+#include "ThreadPool.h"
+#include "Core/CpuProfiler.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	namespace
+	{
+		//index of the calling thread's deques, -1 for threads that do not own any
+		thread_local int32_t worker_index = -1;
+		thread_local JobAllocator* job_allocator = nullptr;
+		//set while the thread runs a background job, nested waits may then keep running background jobs on the same slot
+		thread_local bool background_slot_held = false;
+
+		constexpr uint32_t Lane(JobPriority priority)
+		{
+			return static_cast<uint32_t>(priority);
+		}
+
+		constexpr char const* JOB_SCOPE_NAMES[JOB_PRIORITY_COUNT] = { "Critical Job", "Job", "Background Job" };
+	}
+
+	void ThreadPool::Initialize(ThreadPoolInit const& init)
+	{
+		if (!done.load()) return;
+		static const uint32_t max_threads = std::thread::hardware_concurrency();
+		uint32_t const num_threads = (std::max)(1u, init.worker_count == 0 ? max_threads - 1 : (std::min)(max_threads - 1, init.worker_count));
+		background_worker_limit = init.background_worker_limit == 0 ? (std::max)(1u, num_threads / 2) : (std::min)(num_threads, init.background_worker_limit);
+
+		queues.clear();
+		queues.reserve((num_threads + 1) * JOB_PRIORITY_COUNT);
+		for (uint32_t i = 0; i < (num_threads + 1) * JOB_PRIORITY_COUNT; ++i) queues.push_back(std::make_unique<WorkStealingDeque<Job*>>());
+		io_queue = init.io_thread_count > 0 ? std::make_unique<ConcurrentQueue<Job*>>(1024) : nullptr;
+
+		worker_index = 0;
+		done = false;
+		threads.reserve(num_threads);
+		//an affinity mask only reaches the 64 cores of the current processor group
+		uint32_t const pinnable_cores = (std::min)(max_threads, static_cast<uint32_t>(sizeof(DWORD_PTR) * 8));
+		for (uint32_t i = 0; i < num_threads; ++i)
+		{
+			threads.emplace_back(&ThreadPool::ThreadWork, this, i + 1u);
+			if (init.pin_workers && pinnable_cores > 1) SetThreadAffinityMask(threads.back().native_handle(), DWORD_PTR(1) << ((i + 1) % pinnable_cores));
+		}
+		io_threads.reserve(init.io_thread_count);
+		for (uint32_t i = 0; i < init.io_thread_count; ++i)
+		{
+			io_threads.emplace_back(&ThreadPool::IOThreadWork, this, i);
+			SetThreadPriority(io_threads.back().native_handle(), THREAD_PRIORITY_BELOW_NORMAL);
+		}
+	}
+
+	void ThreadPool::Destroy()
+	{
+		if (done.load()) return;
+		if (io_queue) io_queue->Close();
+		for (auto& thread : io_threads) if (thread.joinable()) thread.join();
+		io_threads.clear();
+
+		done = true;
+		work_signal.fetch_add(1);
+		work_signal.notify_all();
+		for (auto& thread : threads) if (thread.joinable()) thread.join();
+		threads.clear();
+
+		//workers may have dispatched io after the io threads left, new jobs run inline from here on
+		Job* io_job = nullptr;
+		while (io_queue && io_queue->TryPop(io_job)) Execute(io_job);
+		while (Job* job = FindJob(JobPriority::Background)) Execute(job);
+		io_queue = nullptr;
+		worker_index = -1;
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Destroy();
+	}
+
+	void ThreadPool::Wait(JobCounter const& counter, JobPriority lowest)
+	{
+		while (!counter.Done())
+		{
+			if (ExecuteOne(lowest)) continue;
+
+			uint32_t const signal = completion_signal.load();
+			waiting_threads.fetch_add(1);
+			if (!counter.Done() && !ExecuteOne(lowest)) completion_signal.wait(signal);
+			waiting_threads.fetch_sub(1);
+		}
+	}
+
+	bool ThreadPool::ExecuteOne(JobPriority lowest)
+	{
+		Job* job = FindJob(lowest);
+		if (!job) return false;
+		Execute(job);
+		return true;
+	}
+
+	Job* ThreadPool::AllocateJob()
+	{
+		if (!job_allocator)
+		{
+			std::lock_guard<std::mutex> lock(allocators_mutex);
+			job_allocator = allocators.emplace_back(std::make_unique<JobAllocator>()).get();
+		}
+		return job_allocator->Allocate();
+	}
+
+	void ThreadPool::Push(Job* job)
+	{
+		uint32_t const lane = Lane(job->priority);
+		if (worker_index < 0 || !queues[worker_index * JOB_PRIORITY_COUNT + lane]->Push(job))
+		{
+			if (!injected_queues[lane].TryPush(job))
+			{
+				Execute(job);
+				return;
+			}
+		}
+		if (sleeping_workers.load() > 0)
+		{
+			work_signal.fetch_add(1);
+			work_signal.notify_one();
+		}
+	}
+
+	void ThreadPool::PushIO(Job* job)
+	{
+		if (!io_queue) Push(job);
+		else if (!io_queue->TryPush(job)) Execute(job);
+	}
+
+	Job* ThreadPool::FindJob(JobPriority lowest)
+	{
+		int32_t const self = worker_index;
+		uint32_t const count = static_cast<uint32_t>(queues.size() / JOB_PRIORITY_COUNT);
+		for (uint32_t lane = 0; lane <= Lane(lowest); ++lane)
+		{
+			if (lane == Lane(JobPriority::Background) && !background_slot_held && background_workers.load() >= background_worker_limit) break;
+
+			if (self >= 0 && static_cast<uint32_t>(self) < count)
+			{
+				if (Job* job = queues[self * JOB_PRIORITY_COUNT + lane]->Pop()) return job;
+			}
+
+			Job* job = nullptr;
+			if (injected_queues[lane].TryPop(job)) return job;
+
+			for (uint32_t i = 1; i <= count; ++i)
+			{
+				uint32_t const victim = (static_cast<uint32_t>(self + 1) + i) % count;
+				if (static_cast<int32_t>(victim) == self) continue;
+				if (Job* stolen = queues[victim * JOB_PRIORITY_COUNT + lane]->Steal()) return stolen;
+			}
+		}
+		return nullptr;
+	}
+
+	void ThreadPool::Execute(Job* job)
+	{
+		CaseEngineCpuProfileScope(JOB_SCOPE_NAMES[Lane(job->priority)]);
+		if (job->priority == JobPriority::Background && !background_slot_held)
+		{
+			background_workers.fetch_add(1);
+			background_slot_held = true;
+			job->invoke(job->storage);
+			background_slot_held = false;
+			background_workers.fetch_sub(1);
+		}
+		else job->invoke(job->storage);
+
+		JobCounter* counter = job->counter;
+		job->allocator->Free(job);
+
+		if (counter && counter->pending.fetch_sub(1) == 1 && waiting_threads.load() > 0)
+		{
+			completion_signal.fetch_add(1);
+			completion_signal.notify_all();
+		}
+	}
+
+	void ThreadPool::ThreadWork(uint32_t index)
+	{
+		worker_index = static_cast<int32_t>(index);
+		g_CpuProfiler.SetThreadName("Worker " + std::to_string(index));
+		while (true)
+		{
+			if (Job* job = FindJob(JobPriority::Background))
+			{
+				Execute(job);
+				continue;
+			}
+
+			uint32_t const signal = work_signal.load();
+			sleeping_workers.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (Job* job = FindJob(JobPriority::Background))
+			{
+				sleeping_workers.fetch_sub(1);
+				Execute(job);
+				continue;
+			}
+			if (done.load())
+			{
+				sleeping_workers.fetch_sub(1);
+				break;
+			}
+			work_signal.wait(signal);
+			sleeping_workers.fetch_sub(1);
+		}
+		worker_index = -1;
+	}
+
+	void ThreadPool::IOThreadWork(uint32_t index)
+	{
+		g_CpuProfiler.SetThreadName("IO " + std::to_string(index));
+		//io jobs are background jobs but must not count against the workers' background limit
+		background_slot_held = true;
+		Job* job = nullptr;
+		while (io_queue->WaitPop(job)) Execute(job);
+	}
+
+}
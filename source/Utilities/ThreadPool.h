@@ -5,96 +5,342 @@
 
 // Includes
 #pragma once
+#include <cstddef>
 #include <thread>
 #include <future>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <array>
+#include <vector>
+#include <functional>
 #include <type_traits>
+#include <concepts>
+#include <algorithm>
 #include "ConcurrentQueue.h"
+#include "WorkStealingDeque.h"
 #include "Singleton.h"
 
 
 // Namespace Case_Engine
 namespace Case_Engine
 {
-	class ThreadPool : public Singleton<ThreadPool>
+	//lanes are drained in order, a worker only takes a job from a lane when every lane before it is empty
+	enum class JobPriority : uint8_t
 	{
-		friend class Singleton<ThreadPool>;
+		Critical,
+		Normal,
+		Background
+	};
+	inline constexpr uint32_t JOB_PRIORITY_COUNT = 3;
 
+	struct ThreadPoolInit
+	{
+		uint32_t worker_count = 0;				//0 picks hardware_concurrency() - 1
+		uint32_t io_thread_count = 2;
+		uint32_t background_worker_limit = 0;	//workers allowed to run background jobs at once, 0 picks half of them
+		bool pin_workers = false;				//worker i runs on logical core i + 1, the initializing thread keeps core 0 to itself
+	};
+
+	class JobCounter
+	{
+		friend class ThreadPool;
 	public:
+		JobCounter() = default;
+		JobCounter(JobCounter const&) = delete;
+		JobCounter& operator=(JobCounter const&) = delete;
 
-		void Initialize(uint32_t pool_size = std::thread::hardware_concurrency() - 1)
+		bool Done() const
 		{
-			done = false;
-			static const uint32_t max_threads = std::thread::hardware_concurrency();
-			uint16_t const num_threads = pool_size == 0 ? max_threads - 1 : (std::min)(max_threads - 1, pool_size);
+			return pending.load() == 0;
+		}
+
+		uint32_t Pending() const
+		{
+			return pending.load();
+		}
+
+	private:
+		std::atomic<uint32_t> pending = 0;
+	};
 
-			threads.reserve(num_threads);
-			for (uint16_t i = 0; i < num_threads; ++i)
+	class JobAllocator;
+
+	//one cache line pair per job, the functor lives inline unless it does not fit
+	struct alignas(64) Job
+	{
+		static constexpr size_t STORAGE_SIZE = 96;
+
+		alignas(std::max_align_t) std::byte storage[STORAGE_SIZE];
+		void(*invoke)(void*) = nullptr;
+		JobCounter* counter = nullptr;
+		JobAllocator* allocator = nullptr;
+		uint32_t index = 0;
+		JobPriority priority = JobPriority::Normal;
+	};
+	static_assert(sizeof(Job) == 128);
+
+	//fixed slab of jobs owned by one thread; only the owner allocates, any thread frees
+	class JobAllocator
+	{
+		static constexpr uint32_t NIL = static_cast<uint32_t>(-1);
+
+	public:
+		static constexpr uint32_t CAPACITY = 2048;
+
+		JobAllocator() : jobs(std::make_unique<Job[]>(CAPACITY)), next(std::make_unique<std::atomic<uint32_t>[]>(CAPACITY))
+		{
+			for (uint32_t i = 0; i < CAPACITY; ++i)
 			{
-				threads.emplace_back(std::bind(&ThreadPool::ThreadWork, this));
+				jobs[i].allocator = this;
+				jobs[i].index = i;
+				next[i].store(i + 1 < CAPACITY ? i + 1 : NIL, std::memory_order_relaxed);
 			}
 		}
 
-		void Destroy()
+		Job* Allocate()
 		{
-			if (done) return;
+			uint32_t head = free_head.load(std::memory_order_acquire);
+			while (head != NIL)
 			{
-				std::unique_lock<std::mutex> lk(cond_mutex);
-				done = true;
-				cond_var.notify_all();
+				if (free_head.compare_exchange_weak(head, next[head].load(std::memory_order_relaxed), std::memory_order_acquire, std::memory_order_acquire)) return &jobs[head];
 			}
-			for (uint16_t i = 0; i < threads.size(); ++i) if (threads[i].joinable())  threads[i].join();
+			return nullptr;
 		}
 
+		void Free(Job* job)
+		{
+			uint32_t head = free_head.load(std::memory_order_relaxed);
+			do
+			{
+				next[job->index].store(head, std::memory_order_relaxed);
+			} while (!free_head.compare_exchange_weak(head, job->index, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+	private:
+		std::unique_ptr<Job[]> jobs;
+		std::unique_ptr<std::atomic<uint32_t>[]> next;
+		std::atomic<uint32_t> free_head = 0;
+	};
+
+	class ThreadPool;
+
+	//std::future that runs pending jobs while it waits instead of blocking the calling thread
+	template<typename R>
+	class JobFuture
+	{
+	public:
+		JobFuture() = default;
+		JobFuture(std::future<R>&& future, ThreadPool* pool, JobPriority priority) : future(std::move(future)), pool(pool), priority(priority) {}
+
+		bool valid() const
+		{
+			return future.valid();
+		}
+
+		bool ready() const
+		{
+			return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		void wait() const;
+
+		R get()
+		{
+			wait();
+			return future.get();
+		}
+
+	private:
+		std::future<R> future;
+		ThreadPool* pool = nullptr;
+		JobPriority priority = JobPriority::Normal;
+	};
+
+	class JobExecutor;
+
+	//work-stealing pool: every worker and the initializing thread own one deque per lane, other threads go through shared queues.
+	//background jobs run on a limited number of workers so streaming never occupies all of them, blocking file reads go to separate io threads
+	class ThreadPool : public Singleton<ThreadPool>
+	{
+		friend class Singleton<ThreadPool>;
+
+	public:
+
+		void Initialize(ThreadPoolInit const& init = {});
+		void Destroy();
+
 		ThreadPool(ThreadPool const&) = delete;
 		ThreadPool(ThreadPool&&) = delete;
 		ThreadPool& operator=(ThreadPool const&) = delete;
 		ThreadPool& operator=(ThreadPool&&) = delete;
-		~ThreadPool() = default;
+		~ThreadPool();
+
+		template<typename F>
+		void Schedule(JobCounter& counter, F&& f, JobPriority priority = JobPriority::Normal)
+		{
+			if (Job* job = CreateJob(&counter, priority, std::forward<F>(f))) Push(job);
+		}
+
+		//fire and forget, for work that signals its own completion
+		template<typename F>
+		void Dispatch(F&& f, JobPriority priority = JobPriority::Normal)
+		{
+			if (Job* job = CreateJob(nullptr, priority, std::forward<F>(f))) Push(job);
+		}
+
+		//runs f on an io thread, meant for blocking reads that would otherwise park a worker
+		template<typename F>
+		void DispatchIO(F&& f)
+		{
+			if (Job* job = CreateJob(nullptr, JobPriority::Background, std::forward<F>(f))) PushIO(job);
+		}
 
 		template<typename F, typename... Args>
-		auto Submit(F&& f, Args&&... args)
+		auto Submit(JobPriority priority, F&& f, Args&&... args)
 		{
 			using ReturnType = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
-			auto bind_f = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-			auto wrapped_task = std::make_shared<std::packaged_task<ReturnType()>>(bind_f);
-			std::future<ReturnType> result_future = wrapped_task->get_future();
-			auto void_task = [wrapped_task]() {(*wrapped_task)(); };
-			task_queue.Push(std::move(void_task));
-			cond_var.notify_one();
-			return result_future;
+			std::packaged_task<ReturnType()> task([f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable { return std::invoke(std::move(f), std::move(args)...); });
+			JobFuture<ReturnType> result(task.get_future(), this, priority);
+			if (Job* job = CreateJob(nullptr, priority, [task = std::move(task)]() mutable { task(); })) Push(job);
+			return result;
+		}
+
+		template<typename F, typename... Args> requires (!std::same_as<std::decay_t<F>, JobPriority>)
+		auto Submit(F&& f, Args&&... args)
+		{
+			return Submit(JobPriority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+		}
+
+		JobExecutor Executor(JobPriority priority);
+
+		//helps with jobs down to the lowest lane while waiting
+		void Wait(JobCounter const& counter, JobPriority lowest = JobPriority::Normal);
+		bool ExecuteOne(JobPriority lowest = JobPriority::Normal);
+
+		uint32_t NumThreads() const
+		{
+			return static_cast<uint32_t>(threads.size());
+		}
+
+		uint32_t NumIOThreads() const
+		{
+			return static_cast<uint32_t>(io_threads.size());
 		}
 
 	private:
 		std::vector<std::thread> threads;
-		ConcurrentQueue<std::function<void()>> task_queue;
-		bool done = false;
-		std::condition_variable cond_var;
-		std::mutex cond_mutex;
+		std::vector<std::thread> io_threads;
+		std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> queues;
+		std::array<ConcurrentQueue<Job*>, JOB_PRIORITY_COUNT> injected_queues{ ConcurrentQueue<Job*>(4096), ConcurrentQueue<Job*>(4096), ConcurrentQueue<Job*>(4096) };
+		std::unique_ptr<ConcurrentQueue<Job*>> io_queue;
+
+		std::vector<std::unique_ptr<JobAllocator>> allocators;
+		std::mutex allocators_mutex;
+
+		std::atomic<bool> done = true;
+		std::atomic<uint32_t> work_signal = 0;
+		std::atomic<uint32_t> sleeping_workers = 0;
+		std::atomic<uint32_t> completion_signal = 0;
+		std::atomic<uint32_t> waiting_threads = 0;
+		std::atomic<uint32_t> background_workers = 0;
+		uint32_t background_worker_limit = 1;
 
 	private:
 		ThreadPool() = default;
 
-		void ThreadWork()
+		//returns nullptr when the job already ran inline on the calling thread
+		template<typename F>
+		Job* CreateJob(JobCounter* counter, JobPriority priority, F&& f)
 		{
-			std::function <void()> task;
-			bool pop_success;
+			using Functor = std::decay_t<F>;
 
-			while (true)
+			Job* job = done.load(std::memory_order_acquire) ? nullptr : AllocateJob();
+			if (!job)
 			{
-				{
-					std::unique_lock<std::mutex> lk(cond_mutex);
-					while (!done && task_queue.Empty()) cond_var.wait(lk);
-					if (done) return;
-					else pop_success = task_queue.TryPop(task);
-				}
-
-				if (pop_success)
-				{
-					task();
-					task = nullptr;
-				}
+				f();
+				return nullptr;
 			}
+
+			if constexpr (sizeof(Functor) <= Job::STORAGE_SIZE && alignof(Functor) <= alignof(std::max_align_t))
+			{
+				new (job->storage) Functor(std::forward<F>(f));
+				job->invoke = [](void* storage)
+					{
+						Functor* functor = std::launder(reinterpret_cast<Functor*>(storage));
+						(*functor)();
+						functor->~Functor();
+					};
+			}
+			else
+			{
+				using BoxedFunctor = std::unique_ptr<Functor>;
+				new (job->storage) BoxedFunctor(std::make_unique<Functor>(std::forward<F>(f)));
+				job->invoke = [](void* storage)
+					{
+						BoxedFunctor* functor = std::launder(reinterpret_cast<BoxedFunctor*>(storage));
+						(**functor)();
+						functor->~BoxedFunctor();
+					};
+			}
+			job->counter = counter;
+			job->priority = priority;
+			if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+			return job;
 		}
+
+		Job* AllocateJob();
+		void Push(Job* job);
+		void PushIO(Job* job);
+		Job* FindJob(JobPriority lowest);
+		void Execute(Job* job);
+		void ThreadWork(uint32_t index);
+		void IOThreadWork(uint32_t index);
 	};
 	#define g_ThreadPool ThreadPool::Get()
+
+	//adapts one lane of the pool to the executor interface tecs expects
+	class JobExecutor
+	{
+	public:
+		JobExecutor(ThreadPool& pool, JobPriority priority) : pool(pool), priority(priority) {}
+
+		template<typename F>
+		auto Submit(F&& f)
+		{
+			return pool.Submit(priority, std::forward<F>(f));
+		}
+
+		//chunk(first, last) over [0, count), the first chunk runs on the calling thread; no futures, so nothing is allocated
+		template<typename F>
+		void ForEachChunk(size_t count, size_t chunk_size, F const& chunk)
+		{
+			JobCounter counter;
+			for (size_t first = chunk_size; first < count; first += chunk_size)
+			{
+				size_t const last = (std::min)(first + chunk_size, count);
+				pool.Schedule(counter, [&chunk, first, last]() { chunk(first, last); }, priority);
+			}
+			chunk(size_t{ 0 }, (std::min)(chunk_size, count));
+			pool.Wait(counter, priority);
+		}
+
+	private:
+		ThreadPool& pool;
+		JobPriority priority;
+	};
+
+	inline JobExecutor ThreadPool::Executor(JobPriority priority)
+	{
+		return JobExecutor(*this, priority);
+	}
+
+	template<typename R>
+	void JobFuture<R>::wait() const
+	{
+		while (!ready())
+		{
+			if (!pool || !pool->ExecuteOne(priority)) future.wait_for(std::chrono::microseconds(50));
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <atomic>
+#include <memory>
+#include <bit>
+
+
+// Namespace Case_Engine
+namespace Case_Engine
+{
+	//Chase-Lev deque: the owner thread pushes and pops at the bottom, any thread steals from the top.
+	//the capacity is fixed, Push fails instead of growing so callers can fall back to a shared queue
+	template<typename T> requires std::is_pointer_v<T>
+	class WorkStealingDeque
+	{
+	public:
+		explicit WorkStealingDeque(uint32_t capacity = 4096) : mask(std::bit_ceil(capacity) - 1), buffer(std::make_unique<std::atomic<T>[]>(mask + 1))
+		{}
+		WorkStealingDeque(WorkStealingDeque const&) = delete;
+		WorkStealingDeque& operator=(WorkStealingDeque const&) = delete;
+
+		bool Push(T item)
+		{
+			int64_t const b = bottom.load(std::memory_order_relaxed);
+			int64_t const t = top.load(std::memory_order_acquire);
+			if (b - t > static_cast<int64_t>(mask)) return false;
+
+			buffer[b & mask].store(item, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_seq_cst);
+			return true;
+		}
+
+		T Pop()
+		{
+			int64_t const b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_seq_cst);
+			if (t > b)
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T item = buffer[b & mask].load(std::memory_order_relaxed);
+			if (t == b)
+			{
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = nullptr;
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		T Steal()
+		{
+			int64_t t = top.load(std::memory_order_seq_cst);
+			int64_t const b = bottom.load(std::memory_order_seq_cst);
+			if (t >= b) return nullptr;
+
+			T item = buffer[t & mask].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+			return item;
+		}
+
+		bool Empty() const
+		{
+			return bottom.load(std::memory_order_seq_cst) <= top.load(std::memory_order_seq_cst);
+		}
+
+	private:
+		alignas(64) std::atomic<int64_t> top = 0;
+		alignas(64) std::atomic<int64_t> bottom = 0;
+		uint64_t const mask;
+		std::unique_ptr<std::atomic<T>[]> buffer;
+	};
+}
\ No newline at end of file
@@ -30,6 +30,9 @@ int main( int argc, char* argv[])
 	CLIArg& loglevel = parser.AddArg(true, "-loglvl", "--loglevel");
 	CLIArg& maximize = parser.AddArg(false, "-max", "--maximize");
 	CLIArg& vsync = parser.AddArg(false, "-vsync");
+	CLIArg& workers = parser.AddArg(true, "-workers", "--workerthreads");
+	CLIArg& io_threads = parser.AddArg(true, "-io", "--iothreads");
+	CLIArg& pin_workers = parser.AddArg(false, "-pin", "--pinworkers");
 
     MemoryDebugger::SetBreak(275);
 	MemoryDebugger::Checkpoint();
@@ -53,6 +56,9 @@ int main( int argc, char* argv[])
         engine_init.vsync = vsync;
 		engine_init.window = &window;
         engine_init.scene_file = scene.AsStringOr("scene.json");
+        engine_init.thread_pool_init.worker_count = static_cast<uint32_t>(workers.AsIntOr(0));
+        engine_init.thread_pool_init.io_thread_count = static_cast<uint32_t>(io_threads.AsIntOr(2));
+        engine_init.thread_pool_init.pin_workers = pin_workers;
 
         EditorInit editor_init{};
         editor_init.engine_init = std::move(engine_init);
@@ -0,0 +1,236 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "registry.h"
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+
+	//records structural changes without touching the registry, so it can be filled from a worker thread.
+	//playback order is: creates, emplaces grouped by pool, removes grouped by pool, destroys.
+	//entities returned by create are placeholders that only the recording buffer can resolve.
+	class command_buffer
+	{
+		friend class command_queue;
+		using component_id_t = size_t;
+
+		static constexpr version_type placeholder_version = reserved_version;
+
+		class command_list
+		{
+		public:
+			virtual ~command_list() = default;
+			virtual void emplace_all(registry& reg, command_buffer const& buffer) = 0;
+			virtual void remove_all(registry& reg, command_buffer const& buffer) = 0;
+			virtual void clear() = 0;
+			virtual bool empty() const = 0;
+		};
+
+		template<typename C>
+		class typed_command_list final : public command_list
+		{
+		public:
+			virtual void emplace_all(registry& reg, command_buffer const& buffer) override
+			{
+				if (emplaced.empty()) return;
+				for (auto& e : emplaced) e = buffer.resolve(e);
+				reg.insert<C>(emplaced.begin(), emplaced.end(), std::make_move_iterator(components.begin()));
+			}
+
+			virtual void remove_all(registry& reg, command_buffer const& buffer) override
+			{
+				for (auto e : removed) reg.remove<C>(buffer.resolve(e));
+			}
+
+			virtual void clear() override
+			{
+				emplaced.clear();
+				components.clear();
+				removed.clear();
+			}
+
+			virtual bool empty() const override
+			{
+				return emplaced.empty() && removed.empty();
+			}
+
+			std::vector<entity> emplaced;
+			std::vector<C> components;
+			std::vector<entity> removed;
+		};
+
+		template<typename C>
+		typed_command_list<C>& get_command_list()
+		{
+			auto component_id = registry::component_id_generator::template type<C>;
+			if (component_id >= lists.size()) lists.resize(component_id + 1);
+
+			if (auto&& list = lists[component_id]; !list)
+				list.reset(new typed_command_list<C>());
+
+			return static_cast<typed_command_list<C>&>(*lists[component_id]);
+		}
+
+		static bool is_placeholder(entity e)
+		{
+			return get_version(e) == placeholder_version;
+		}
+
+		entity resolve(entity e) const
+		{
+			if (!is_placeholder(e)) return e;
+			assert(get_index(e) < created.size());
+			return created[get_index(e)];
+		}
+
+		//each phase runs across every buffer before the next one starts, so one batch touches each pool once
+		template<typename It>
+		static void playback(registry& reg, It first, It last)
+		{
+			component_id_t list_count = 0;
+			for (auto it = first; it != last; ++it)
+			{
+				command_buffer& buffer = *it;
+				buffer.created.clear();
+				buffer.created.reserve(buffer.create_count);
+				reg.create(buffer.create_count, std::back_inserter(buffer.created));
+				list_count = (std::max)(list_count, buffer.lists.size());
+			}
+
+			for (component_id_t id = 0; id < list_count; ++id)
+				for (auto it = first; it != last; ++it)
+					if (id < it->lists.size() && it->lists[id]) it->lists[id]->emplace_all(reg, *it);
+
+			for (component_id_t id = 0; id < list_count; ++id)
+				for (auto it = first; it != last; ++it)
+					if (id < it->lists.size() && it->lists[id]) it->lists[id]->remove_all(reg, *it);
+
+			std::vector<entity> destroyed;
+			for (auto it = first; it != last; ++it)
+				for (auto e : it->destroyed) destroyed.push_back(it->resolve(e));
+			std::sort(destroyed.begin(), destroyed.end());
+			destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+			reg.destroy(destroyed.begin(), destroyed.end());
+
+			for (auto it = first; it != last; ++it) it->clear();
+		}
+
+	public:
+		command_buffer() = default;
+		command_buffer(command_buffer const&) = delete;
+		command_buffer(command_buffer&&) = default;
+		command_buffer& operator=(command_buffer const&) = delete;
+		command_buffer& operator=(command_buffer&&) = default;
+		~command_buffer() = default;
+
+		[[nodiscard]]
+		entity create()
+		{
+			return make_entity(static_cast<index_type>(create_count++), placeholder_version);
+		}
+
+		void destroy(entity e)
+		{
+			destroyed.push_back(e);
+		}
+
+		template<typename C, typename... Args>
+		void emplace(entity e, Args&&... args)
+		{
+			using component_type = std::remove_const_t<C>;
+			auto& list = get_command_list<component_type>();
+			list.emplaced.push_back(e);
+			if constexpr (std::is_aggregate_v<component_type>) list.components.push_back(component_type{ std::forward<Args>(args)... });
+			else list.components.emplace_back(std::forward<Args>(args)...);
+		}
+
+		template<typename C>
+		void remove(entity e)
+		{
+			get_command_list<std::remove_const_t<C>>().removed.push_back(e);
+		}
+
+		bool empty() const
+		{
+			return create_count == 0 && destroyed.empty() &&
+				std::all_of(lists.begin(), lists.end(), [](auto const& list) { return !list || list->empty(); });
+		}
+
+		void playback(registry& reg)
+		{
+			playback(reg, this, this + 1);
+		}
+
+		void clear()
+		{
+			create_count = 0;
+			destroyed.clear();
+			for (auto& list : lists)
+				if (list) list->clear();
+		}
+
+	private:
+		size_t create_count = 0;
+		std::vector<entity> created;
+		std::vector<entity> destroyed;
+		std::vector<std::unique_ptr<command_list>> lists;
+	};
+
+	//hands every thread its own command_buffer and plays all of them back as one batch
+	class command_queue
+	{
+		inline static std::atomic<uint64_t> instance_counter{ 0 };
+
+	public:
+		command_queue() : instance_id{ ++instance_counter }
+		{}
+		command_queue(command_queue const&) = delete;
+		command_queue& operator=(command_queue const&) = delete;
+
+		command_buffer& local()
+		{
+			thread_local struct
+			{
+				uint64_t owner = 0;
+				command_buffer* buffer = nullptr;
+			} cache;
+
+			//the cache only remembers the last queue, threads switching between queues find their buffer again in thread_buffers
+			if (cache.owner != instance_id)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto [it, inserted] = thread_buffers.try_emplace(std::this_thread::get_id(), nullptr);
+				if (inserted) it->second = &buffers.emplace_back();
+				cache.buffer = it->second;
+				cache.owner = instance_id;
+			}
+			return *cache.buffer;
+		}
+
+		//call at a sync point, when no thread is recording
+		void playback(registry& reg)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			command_buffer::playback(reg, buffers.begin(), buffers.end());
+		}
+
+	private:
+		uint64_t const instance_id;
+		std::mutex mutex;
+		std::deque<command_buffer> buffers;
+		std::unordered_map<std::thread::id, command_buffer*> thread_buffers;
+	};
+
+}
\ No newline at end of file
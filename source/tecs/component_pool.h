@@ -6,6 +6,8 @@
 // Includes
 #pragma once
 #include "sparse_set.h"
+#include "component_storage.h"
+#include <mutex>
 
 
 // Namespace Case_Engine
@@ -21,28 +23,140 @@ class component_pool : public sparse_set
     using base_type = sparse_set;
     using component_type = C;
     using size_type = base_type::size_type;
+    using storage_type = storage_for<C>;
+    using mirror_type = mirror_for<C>;
+
+    static constexpr bool mirrored = soa_component<C>;
 
 public:
     virtual void remove(entity e) override
     {
-        using std::swap;
         auto index = base_type::index(e);
-        swap(components[index], components.back());
-        components.pop_back();
+        components.pop_swap(index);
+        if constexpr (mirrored) mirror.pop_swap(index);
+        if (tracked)
+        {
+            ticks[index] = ticks.back();
+            ticks.pop_back();
+        }
         base_type::remove(e);
     }
 
     virtual void clear() override
     {
         components.clear();
+        ticks.clear();
+        if constexpr (mirrored)
+        {
+            mirror.clear();
+            stale.clear();
+            stale_all = false;
+        }
         base_type::clear();
     }
 
+    virtual void reserve(size_type capacity) override
+    {
+        components.reserve(capacity);
+        if constexpr (mirrored) mirror.reserve(capacity);
+        if (tracked) ticks.reserve(capacity);
+        base_type::reserve(capacity);
+    }
+
+    virtual void shrink_to_fit() override
+    {
+        components.shrink_to_fit();
+        if constexpr (mirrored) mirror.shrink_to_fit();
+        ticks.shrink_to_fit();
+        base_type::shrink_to_fit();
+    }
+
+    virtual void swap_at(size_type lhs, size_type rhs) override
+    {
+        components.swap_at(lhs, rhs);
+        if constexpr (mirrored) mirror.swap_at(lhs, rhs);
+        if (tracked) std::swap(ticks[lhs], ticks[rhs]);
+        base_type::swap_at(lhs, rhs);
+    }
+
     size_type size() const
     {
         return components.size();
     }
 
+    template<typename Compare>
+    bool sort_n(size_type count, Compare compare)
+    {
+        if constexpr (std::is_invocable_r_v<bool, Compare&, component_type const&, component_type const&>)
+            return base_type::sort_positions(count, [this, &compare](size_type lhs, size_type rhs) { return compare(std::as_const(components[lhs]), std::as_const(components[rhs])); });
+        else return base_type::sort_n(count, std::move(compare));
+    }
+
+    template<typename Compare>
+    void sort(Compare compare)
+    {
+        sort_n(size(), std::move(compare));
+    }
+
+    void track(bool enable = true)
+    {
+        tracked = enable;
+        if (tracked) ticks.assign(components.size(), current_tick);
+        else ticks.clear();
+    }
+
+    bool tracking() const
+    {
+        return tracked;
+    }
+
+    void touch(entity e)
+    {
+        if (tracked) ticks[base_type::index(e)] = current_tick;
+        if constexpr (mirrored)
+        {
+            //registry::get and replace may run on several workers at once
+            std::lock_guard<std::mutex> lock(stale_mutex);
+            if (!stale_all) stale.push_back(e);
+        }
+    }
+
+    // one span per field of component_traits<C>::soa_streams, in packed order;
+    // components written without touch (get_at, view iteration) are not picked up;
+    // touch is safe from any thread, streams() must run at a sync point where nothing touches the pool
+    auto streams() requires mirrored
+    {
+        if (stale_all)
+        {
+            mirror.resize(components.size());
+            for (size_type pos = 0; pos < components.size(); ++pos) mirror.refresh(pos, components[pos]);
+        }
+        else
+        {
+            for (auto e : stale) if (contains(e)) mirror.refresh(base_type::index(e), components[base_type::index(e)]);
+        }
+        stale.clear();
+        stale_all = false;
+        return mirror.spans();
+    }
+
+    // untracked pools report every component as changed
+    bool changed_at(size_type pos, tick_type since) const
+    {
+        assert(pos < components.size());
+        return !tracked || ticks[pos] >= since;
+    }
+
+    bool changed(entity e, tick_type since) const
+    {
+        return changed_at(base_type::index(e), since);
+    }
+
+    bool any_changed(tick_type since) const
+    {
+        return !tracked || std::any_of(ticks.begin(), ticks.end(), [since](tick_type t) { return t >= since; });
+    }
+
     component_type const& get(entity e) const
     {
         return components[base_type::index(e)];
@@ -53,6 +167,18 @@ public:
         return components[base_type::index(e)];
     }
 
+    component_type const& get_at(size_type pos) const
+    {
+        assert(pos < components.size());
+        return components[pos];
+    }
+
+    component_type& get_at(size_type pos)
+    {
+        assert(pos < components.size());
+        return components[pos];
+    }
+
     component_type const* get_if(entity e) const
     {
         if(contains(e)) return &components[base_type::index(e)];
@@ -65,28 +191,85 @@ public:
         return nullptr;
     }
 
+    component_type const* raw() const requires std::same_as<storage_type, dense_storage<C>>
+    {
+        return components.data();
+    }
+
+    component_type* raw() requires std::same_as<storage_type, dense_storage<C>>
+    {
+        return components.data();
+    }
+
+    void assign(entity const* first, size_type count)
+    {
+        clear();
+        components.resize(count);
+        if constexpr (mirrored)
+        {
+            mirror.resize(count);
+            stale_all = true;
+        }
+        if (tracked) ticks.assign(count, current_tick);
+        base_type::insert(first, first + count);
+    }
+
     template<typename... Args>
     void emplace(entity e, Args&&... args)
     {
         assert(!contains(e));
-        if constexpr (std::is_aggregate_v<component_type>)  components.push_back(component_type{ std::forward<Args>(args)... });
-        else components.emplace_back(std::forward<Args>(args)...);
+        components.emplace_back(std::forward<Args>(args)...);
+        if constexpr (mirrored) mirror.push_back(components[components.size() - 1]);
+        if (tracked) ticks.push_back(current_tick);
         base_type::emplace(e);
     }
 
     void add(entity e, component_type const& c)
     {
         assert(!contains(e));
-        components.push_back(c);
+        components.emplace_back(c);
+        if constexpr (mirrored) mirror.push_back(c);
+        if (tracked) ticks.push_back(current_tick);
         base_type::emplace(e);
     }
 
+    template<typename It, typename CIt> requires std::input_iterator<CIt>
+    void insert(It first, It last, CIt from)
+    {
+        auto const count = static_cast<size_type>(std::distance(first, last));
+        components.reserve(components.size() + count);
+        for (size_type i = 0; i < count; ++i, ++from) components.emplace_back(*from);
+        if constexpr (mirrored)
+        {
+            mirror.reserve(components.size());
+            for (size_type pos = components.size() - count; pos < components.size(); ++pos) mirror.push_back(components[pos]);
+        }
+        if (tracked) ticks.resize(components.size(), current_tick);
+        base_type::insert(first, last);
+    }
+
+    template<typename It>
+    void insert(It first, It last, component_type const& value)
+    {
+        auto const count = static_cast<size_type>(std::distance(first, last));
+        components.reserve(components.size() + count);
+        for (size_type i = 0; i < count; ++i) components.emplace_back(value);
+        if constexpr (mirrored)
+        {
+            mirror.reserve(components.size());
+            for (size_type i = 0; i < count; ++i) mirror.push_back(value);
+        }
+        if (tracked) ticks.resize(components.size(), current_tick);
+        base_type::insert(first, last);
+    }
+
     template<typename... Args>
     void replace(entity e, Args&&... args)
     {
         assert(contains(e));
         auto&& component = components[base_type::index(e)];
         component = component_type(std::forward<Args>(args)...);
+        touch(e);
     }
 
     void replace(entity e, component_type const& c)
@@ -94,6 +277,7 @@ public:
         assert(contains(e));
         auto&& component = components[base_type::index(e)];
         component = c;
+        touch(e);
     }
 
     template<typename... F> requires (component_updater<component_type, F> && ...)
@@ -101,12 +285,19 @@ public:
     {
         auto&& component = components[base_type::index(e)];
         (std::forward<F>(func)(component), ...);
+        touch(e);
         return component;
     }
 
 
 private:
-    std::vector<component_type> components;
+    storage_type components;
+    std::vector<tick_type> ticks;
+    bool tracked = false;
+    [[no_unique_address]] mirror_type mirror;
+    std::vector<entity> stale;
+    std::mutex stale_mutex;
+    bool stale_all = false;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,341 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "component_traits.h"
+#include <vector>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <span>
+#include <cassert>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+
+	template<typename C>
+	class dense_storage
+	{
+	public:
+		using size_type = size_t;
+
+	public:
+		size_type size() const
+		{
+			return components.size();
+		}
+
+		C& operator[](size_type pos)
+		{
+			return components[pos];
+		}
+
+		C const& operator[](size_type pos) const
+		{
+			return components[pos];
+		}
+
+		template<typename... Args>
+		C& emplace_back(Args&&... args)
+		{
+			if constexpr (std::is_aggregate_v<C>) return components.emplace_back(C{ std::forward<Args>(args)... });
+			else return components.emplace_back(std::forward<Args>(args)...);
+		}
+
+		void pop_swap(size_type pos)
+		{
+			using std::swap;
+			swap(components[pos], components.back());
+			components.pop_back();
+		}
+
+		void swap_at(size_type lhs, size_type rhs)
+		{
+			using std::swap;
+			swap(components[lhs], components[rhs]);
+		}
+
+		void resize(size_type count)
+		{
+			components.resize(count);
+		}
+
+		void reserve(size_type capacity)
+		{
+			components.reserve(capacity);
+		}
+
+		void shrink_to_fit()
+		{
+			components.shrink_to_fit();
+		}
+
+		void clear()
+		{
+			components.clear();
+		}
+
+		C* data()
+		{
+			return components.data();
+		}
+
+		C const* data() const
+		{
+			return components.data();
+		}
+
+	private:
+		std::vector<C> components;
+	};
+
+	//components live in fixed-size pages and are addressed through a slot per packed position,
+	//so growth, removal and sorting only move slot indices and references stay valid until the component is removed
+	template<typename C, size_t PageSize>
+	class paged_storage
+	{
+		using slot_type = uint32_t;
+
+		struct page
+		{
+			alignas(C) std::byte data[sizeof(C) * PageSize];
+		};
+
+		C* slot_ptr(slot_type slot) const
+		{
+			return std::launder(reinterpret_cast<C*>(pages[slot / PageSize]->data) + slot % PageSize);
+		}
+
+		slot_type acquire_slot()
+		{
+			if (!free_slots.empty())
+			{
+				slot_type slot = free_slots.back();
+				free_slots.pop_back();
+				return slot;
+			}
+			if (next_slot == pages.size() * PageSize) pages.push_back(std::make_unique_for_overwrite<page>());
+			return next_slot++;
+		}
+
+	public:
+		using size_type = size_t;
+
+	public:
+		paged_storage() = default;
+		paged_storage(paged_storage const&) = delete;
+		paged_storage& operator=(paged_storage const&) = delete;
+		~paged_storage()
+		{
+			clear();
+		}
+
+		size_type size() const
+		{
+			return slots.size();
+		}
+
+		C& operator[](size_type pos)
+		{
+			return *slot_ptr(slots[pos]);
+		}
+
+		C const& operator[](size_type pos) const
+		{
+			return *slot_ptr(slots[pos]);
+		}
+
+		template<typename... Args>
+		C& emplace_back(Args&&... args)
+		{
+			slot_type slot = acquire_slot();
+			C* component = nullptr;
+			try
+			{
+				if constexpr (std::is_aggregate_v<C>) component = ::new (slot_ptr(slot)) C{ std::forward<Args>(args)... };
+				else component = ::new (slot_ptr(slot)) C(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				free_slots.push_back(slot);
+				throw;
+			}
+			slots.push_back(slot);
+			return *component;
+		}
+
+		void pop_swap(size_type pos)
+		{
+			std::destroy_at(slot_ptr(slots[pos]));
+			free_slots.push_back(slots[pos]);
+			slots[pos] = slots.back();
+			slots.pop_back();
+		}
+
+		void swap_at(size_type lhs, size_type rhs)
+		{
+			std::swap(slots[lhs], slots[rhs]);
+		}
+
+		void resize(size_type count)
+		{
+			while (slots.size() > count) pop_swap(slots.size() - 1);
+			reserve(count);
+			while (slots.size() < count) emplace_back();
+		}
+
+		void reserve(size_type capacity)
+		{
+			slots.reserve(capacity);
+			while (pages.size() * PageSize < capacity) pages.push_back(std::make_unique_for_overwrite<page>());
+		}
+
+		void shrink_to_fit()
+		{
+			if (slots.empty())
+			{
+				pages.clear();
+				free_slots.clear();
+				next_slot = 0;
+			}
+			pages.shrink_to_fit();
+			slots.shrink_to_fit();
+			free_slots.shrink_to_fit();
+		}
+
+		void clear()
+		{
+			for (slot_type slot : slots) std::destroy_at(slot_ptr(slot));
+			slots.clear();
+			free_slots.clear();
+			next_slot = 0;
+		}
+
+	private:
+		std::vector<std::unique_ptr<page>> pages;
+		std::vector<slot_type> slots;
+		std::vector<slot_type> free_slots;
+		slot_type next_slot = 0;
+	};
+
+	template<typename C>
+	concept soa_component = requires(C const& c)
+	{
+		typename component_traits<C>::soa_streams;
+		{ component_traits<C>::extract(c) } -> std::same_as<typename component_traits<C>::soa_streams>;
+	};
+
+	//keeps the fields returned by component_traits<C>::extract in one contiguous stream per field, in packed order
+	template<typename C, typename = typename component_traits<C>::soa_streams>
+	class soa_mirror;
+
+	template<typename C, typename... Ts>
+	class soa_mirror<C, std::tuple<Ts...>>
+	{
+		template<typename F>
+		void for_each_stream(F&& f)
+		{
+			std::apply([&f](auto&... stream) { (f(stream), ...); }, streams);
+		}
+
+		template<size_t... I>
+		void store(size_t pos, std::tuple<Ts...> const& values, std::index_sequence<I...>)
+		{
+			((std::get<I>(streams)[pos] = std::get<I>(values)), ...);
+		}
+
+	public:
+		using size_type = size_t;
+		using spans_type = std::tuple<std::span<Ts>...>;
+
+	public:
+		size_type size() const
+		{
+			return std::get<0>(streams).size();
+		}
+
+		void push_back(C const& component)
+		{
+			for_each_stream([](auto& stream) { stream.emplace_back(); });
+			refresh(size() - 1, component);
+		}
+
+		void refresh(size_type pos, C const& component)
+		{
+			store(pos, component_traits<C>::extract(component), std::index_sequence_for<Ts...>{});
+		}
+
+		void pop_swap(size_type pos)
+		{
+			for_each_stream([pos](auto& stream) { stream[pos] = stream.back(); stream.pop_back(); });
+		}
+
+		void swap_at(size_type lhs, size_type rhs)
+		{
+			for_each_stream([lhs, rhs](auto& stream) { std::swap(stream[lhs], stream[rhs]); });
+		}
+
+		void resize(size_type count)
+		{
+			for_each_stream([count](auto& stream) { stream.resize(count); });
+		}
+
+		void reserve(size_type capacity)
+		{
+			for_each_stream([capacity](auto& stream) { stream.reserve(capacity); });
+		}
+
+		void shrink_to_fit()
+		{
+			for_each_stream([](auto& stream) { stream.shrink_to_fit(); });
+		}
+
+		void clear()
+		{
+			for_each_stream([](auto& stream) { stream.clear(); });
+		}
+
+		spans_type spans()
+		{
+			return std::apply([](auto&... stream) { return spans_type{ std::span(stream)... }; }, streams);
+		}
+
+	private:
+		std::tuple<std::vector<Ts>...> streams;
+	};
+
+	struct no_mirror {};
+
+	namespace details
+	{
+		template<typename C, storage_policy = component_traits<C>::storage>
+		struct storage_selector
+		{
+			using type = dense_storage<C>;
+		};
+
+		template<typename C>
+		struct storage_selector<C, storage_policy::paged>
+		{
+			using type = paged_storage<C, component_traits<C>::page_size>;
+		};
+
+		template<typename C>
+		struct mirror_selector
+		{
+			using type = soa_mirror<C>;
+		};
+	}
+
+	template<typename C>
+	using storage_for = typename details::storage_selector<C>::type;
+
+	template<typename C>
+	using mirror_for = typename std::conditional_t<soa_component<C>, details::mirror_selector<C>, std::type_identity<no_mirror>>::type;
+
+}
\ No newline at end of file
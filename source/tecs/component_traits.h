@@ -0,0 +1,31 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include <cstddef>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+
+	enum class storage_policy
+	{
+		dense,	//one contiguous vector, relocates on growth and on removal
+		paged	//fixed-size blocks, components never move once constructed
+	};
+
+	//specialize per component type to change how its pool stores it.
+	//a specialization can also mirror hot fields into separate streams by declaring
+	//using soa_streams = std::tuple<Ts...>; and static soa_streams extract(C const&);
+	template<typename C>
+	struct component_traits
+	{
+		static constexpr storage_policy storage = storage_policy::dense;
+		static constexpr size_t page_size = 256;
+	};
+
+}
\ No newline at end of file
@@ -19,6 +19,9 @@ namespace Case_Engine::tecs
     using index_type    = uint32_t;
     using version_type  = uint32_t;
 
+    // never given to a live entity, command_buffer uses it to mark placeholders
+    inline constexpr version_type reserved_version = static_cast<version_type>(-1);
+
 
     inline constexpr entity make_entity(index_type index, version_type version = 0)
     {
@@ -34,7 +37,7 @@ namespace Case_Engine::tecs
         return static_cast<underlying_type>(e);
     }
 
-    inline constexpr version_type get_index(entity e)
+    inline constexpr index_type get_index(entity e)
     {
         auto integer = as_integer(e);
 
@@ -52,7 +55,7 @@ namespace Case_Engine::tecs
     {
         auto integer = as_integer(e);
 
-        return std::make_pair(static_cast<index_type>(integer), static_cast<version_type>(integer << 32));
+        return std::make_pair(static_cast<index_type>(integer), static_cast<version_type>(integer >> 32));
     }
 
     inline constexpr entity null_entity = make_entity(static_cast<index_type>(-1));
@@ -0,0 +1,130 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "entity_view.h"
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+
+	template <typename F, typename... Cs>
+	concept valid_group_each_function = requires(entity e, Cs&... cs, F && f) { { f(e, cs...) } ->std::same_as<void>; };
+
+	// Entities owned by a group occupy the range [0, size()) of every owned pool,
+	// at the same position in each one, so iteration needs no membership tests.
+	template<typename... Cs>
+	class entity_group
+	{
+		static_assert(sizeof...(Cs) > 1, "Group has to own at least two component types!");
+
+		using first_type = std::tuple_element_t<0, std::tuple<Cs...>>;
+
+		component_pool<first_type> const* lead() const
+		{
+			return std::get<component_pool<first_type>*>(pools);
+		}
+
+	public:
+		using size_type = size_t;
+		using iterator = sparse_set::const_iterator;
+
+	public:
+
+		entity_group() : pools{}, length{}
+		{}
+
+		entity_group(size_type const& length, component_pool<Cs>&... components)
+			: pools{ &components... }, length{ &length }
+		{}
+
+		explicit operator bool() const
+		{
+			return length != nullptr;
+		}
+
+		size_type size() const
+		{
+			return *length;
+		}
+
+		bool empty() const
+		{
+			return *length == 0;
+		}
+
+		bool contains(entity e) const
+		{
+			return lead()->contains(e) && lead()->index(e) < *length;
+		}
+
+		iterator begin() const
+		{
+			return lead()->begin();
+		}
+
+		iterator end() const
+		{
+			return lead()->begin() + *length;
+		}
+
+		entity operator[](size_type pos) const
+		{
+			assert(pos < *length);
+			return (*lead())[pos];
+		}
+
+		template <typename F> requires valid_each_function<F>
+		void each(F&& f) const
+		{
+			for (auto e : *this) f(e);
+		}
+
+		template <typename F> requires valid_group_each_function<F, Cs...>
+		void each(F&& f) const
+		{
+			entity const* entities = lead()->data();
+			for (size_type pos = 0, count = *length; pos < count; ++pos)
+				f(entities[pos], std::get<component_pool<Cs>*>(pools)->get_at(pos)...);
+		}
+
+		template<typename Compare>
+		void sort(Compare compare) const
+		{
+			auto* pool = std::get<component_pool<first_type>*>(pools);
+			if (!pool->sort_n(*length, std::move(compare))) return;
+			([this, pool](sparse_set* other) { if (other != pool) other->respect(*pool, *length); }(std::get<component_pool<Cs>*>(pools)), ...);
+		}
+
+		template<typename... _Cs> requires (sizeof...(_Cs) != 1)
+		decltype(auto) get(entity e) const
+		{
+			static_assert(details::is_subset_of<std::tuple<std::remove_const_t<_Cs>...>, std::tuple<Cs...> >);
+			assert(contains(e));
+
+			auto const pos = lead()->index(e);
+			if constexpr (sizeof...(_Cs) == 0)
+				return std::forward_as_tuple(std::get<component_pool<Cs>*>(pools)->get_at(pos)...);
+			else
+				return std::forward_as_tuple(const_cast<_Cs&>(std::get<component_pool<std::remove_const_t<_Cs>>*>(pools)->get_at(pos)) ...);
+		}
+
+		template<typename C>
+		decltype(auto) get(entity e) const
+		{
+			static_assert(details::contains<std::remove_const_t<C>, Cs...>);
+			assert(contains(e));
+
+			return (const_cast<C&>(std::get<component_pool<std::remove_const_t<C>>*>(pools)->get_at(lead()->index(e))));
+		}
+
+	private:
+		std::tuple<component_pool<Cs>*...> const pools;
+		size_type const* length;
+	};
+
+}
@@ -24,11 +24,169 @@ namespace Case_Engine::tecs
         template <typename... Ts, typename... Us>
         constexpr bool is_subset_of<std::tuple<Ts...>, std::tuple<Us...>>
             = (contains<Ts, Us...> && ...);
+
+        inline constexpr size_t default_chunk_size = 1024;
+        inline constexpr size_t max_excluded = 4;
+
+        class excluded_sets
+        {
+        public:
+            excluded_sets() = default;
+
+            template<typename... Sets>
+            explicit excluded_sets(Sets const*... excluded) : sets{ static_cast<sparse_set const*>(excluded)... }, count{ sizeof...(Sets) }
+            {
+                static_assert(sizeof...(Sets) <= max_excluded, "Too many excluded component types!");
+            }
+
+            bool rejects(entity e) const
+            {
+                for (size_t i = 0; i < count; ++i) if (sets[i]->contains(e)) return true;
+                return false;
+            }
+
+            excluded_sets merge(excluded_sets const& other) const
+            {
+                excluded_sets merged = *this;
+                for (size_t i = 0; i < other.count; ++i)
+                {
+                    assert(merged.count < max_excluded && "Too many excluded component types!");
+                    merged.sets[merged.count++] = other.sets[i];
+                }
+                return merged;
+            }
+
+        private:
+            std::array<sparse_set const*, max_excluded> sets{};
+            size_t count = 0;
+        };
+
+        template<typename It>
+        class excluding_iterator
+        {
+            bool valid() const
+            {
+                return !excluded.rejects(*it);
+            }
+
+        public:
+            using difference_type = typename std::iterator_traits<It>::difference_type;
+            using value_type = typename std::iterator_traits<It>::value_type;
+            using pointer = typename std::iterator_traits<It>::pointer;
+            using reference = typename std::iterator_traits<It>::reference;
+            using iterator_category = std::bidirectional_iterator_tag;
+
+        public:
+            excluding_iterator() = default;
+
+            excluding_iterator(It from, It to, It curr, excluded_sets const& excluded)
+                : first{ from }, last{ to }, it{ curr }, excluded{ excluded }
+            {
+                if (it != last && !valid()) ++(*this);
+            }
+
+            excluding_iterator& operator++()
+            {
+                while (++it != last && !valid());
+                return *this;
+            }
+
+            excluding_iterator operator++(int)
+            {
+                excluding_iterator orig = *this;
+                return ++(*this), orig;
+            }
+
+            excluding_iterator& operator--()
+            {
+                while (--it != first && !valid());
+                return *this;
+            }
+
+            excluding_iterator operator--(int)
+            {
+                excluding_iterator orig = *this;
+                return operator--(), orig;
+            }
+
+            bool operator==(excluding_iterator const& other) const
+            {
+                return other.it == it;
+            }
+
+            bool operator!=(excluding_iterator const& other) const
+            {
+                return !(*this == other);
+            }
+
+            pointer operator->() const
+            {
+                return &*it;
+            }
+
+            reference operator*() const
+            {
+                return *operator->();
+            }
+
+        private:
+            It first{};
+            It last{};
+            It it{};
+            excluded_sets excluded;
+        };
+
+        template <typename Executor, typename F>
+        void parallel_chunks(Executor& executor, size_t count, size_t chunk_size, F const& chunk)
+        {
+            if (count == 0) return;
+            chunk_size = (std::max)(chunk_size, size_t{ 1 });
+
+            //executors that can fan out without futures skip the per chunk shared state
+            if constexpr (requires { executor.ForEachChunk(count, chunk_size, chunk); })
+            {
+                executor.ForEachChunk(count, chunk_size, chunk);
+                return;
+            }
+
+            std::vector<decltype(executor.Submit(std::declval<void(*)()>()))> pending;
+            pending.reserve(count / chunk_size);
+            for (size_t first = chunk_size; first < count; first += chunk_size)
+            {
+                size_t const last = (std::min)(first + chunk_size, count);
+                pending.push_back(executor.Submit([&chunk, first, last]() { chunk(first, last); }));
+            }
+
+            chunk(size_t{ 0 }, (std::min)(chunk_size, count));
+            for (auto& result : pending) result.wait();
+        }
+
+        template <typename Executor, typename T, typename F, typename R>
+        T parallel_reduce_chunks(Executor& executor, size_t count, size_t chunk_size, T identity, F const& chunk, R const& reduce)
+        {
+            chunk_size = (std::max)(chunk_size, size_t{ 1 });
+            std::vector<T> locals((count + chunk_size - 1) / chunk_size, identity);
+            parallel_chunks(executor, count, chunk_size, [&](size_t first, size_t last) { chunk(locals[first / chunk_size], first, last); });
+            for (auto& local : locals) reduce(identity, std::move(local));
+            return identity;
+        }
     }
 
+    template <typename... Es>
+    struct exclude_t {};
+
+    template <typename... Es>
+    inline constexpr exclude_t<Es...> exclude{};
+
     template <typename F>
     concept valid_each_function = requires(entity e, F&& f) { { f(e) } ->std::same_as<void>; };
 
+    template <typename F, typename... Cs>
+    concept valid_view_each_function = requires(entity e, Cs&... cs, F&& f) { { f(e, cs...) } ->std::same_as<void>; };
+
+    template <typename E>
+    concept valid_executor = requires(E& executor) { executor.Submit(std::declval<void(*)()>()).wait(); };
+
     template<typename... Cs>
     class entity_view
     {
@@ -62,14 +220,15 @@ namespace Case_Engine::tecs
             bool valid() const
             {
                 const auto e = *it;
-                return std::all_of(std::begin(unchecked), std::end(unchecked), [e](sparse_set const* curr) { return curr->contains(e); });
+                return std::all_of(std::begin(unchecked), std::end(unchecked), [e](sparse_set const* curr) { return curr->contains(e); }) && !excluded.rejects(e);
             }
 
-            view_iterator(It from, It to, It curr, unchecked_type unchecked)
+            view_iterator(It from, It to, It curr, unchecked_type unchecked, details::excluded_sets const& excluded)
                 :   first{ from },
                     last{ to },
                     it{ curr },
-                    unchecked{ unchecked }
+                    unchecked{ unchecked },
+                    excluded{ excluded }
             {
                 if (it != last && !valid())  ++(*this);
             }
@@ -83,7 +242,7 @@ namespace Case_Engine::tecs
 
         public:
 
-            view_iterator() : view_iterator{ It{}, It{}, It{}, unchecked_type{} }
+            view_iterator() : view_iterator{ It{}, It{}, It{}, unchecked_type{}, details::excluded_sets{} }
             {}
 
             view_iterator& operator++()
@@ -133,6 +292,106 @@ namespace Case_Engine::tecs
             It last;
             It it;
             unchecked_type unchecked;
+            details::excluded_sets excluded;
+        };
+
+        using pools_type = std::tuple<component_pool<Cs>*...>;
+        using positions_type = std::array<size_t, sizeof...(Cs)>;
+
+        // resolves every component position once per step, the driving pool's position is the step itself
+        class each_iterator
+        {
+            friend class entity_view<Cs...>;
+
+            each_iterator(pools_type const& pools, sparse_set const* view, details::excluded_sets const& excluded, size_t pos)
+                : pools{ pools }, view{ view }, excluded{ excluded }, pos{ pos }
+            {
+                seek();
+            }
+
+            bool locate()
+            {
+                entity const e = (*view)[pos];
+                positions = { (std::get<component_pool<Cs>*>(pools) == view ? pos : std::get<component_pool<Cs>*>(pools)->find(e))... };
+                return std::find(positions.begin(), positions.end(), sparse_set::npos) == positions.end() && !excluded.rejects(e);
+            }
+
+            void seek()
+            {
+                for (size_t const count = view ? view->size() : 0; pos < count && !locate(); ++pos);
+            }
+
+            template<size_t... I>
+            auto fetch(std::index_sequence<I...>) const
+            {
+                return std::tuple<entity, Cs&...>{ (*view)[pos], std::get<I>(pools)->get_at(positions[I])... };
+            }
+
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::tuple<entity, Cs&...>;
+            using pointer = void;
+            using reference = value_type;
+            using iterator_category = std::input_iterator_tag;
+
+        public:
+            each_iterator() = default;
+
+            each_iterator& operator++()
+            {
+                ++pos;
+                seek();
+                return *this;
+            }
+
+            each_iterator operator++(int)
+            {
+                each_iterator orig = *this;
+                return ++(*this), orig;
+            }
+
+            reference operator*() const
+            {
+                return fetch(std::index_sequence_for<Cs...>{});
+            }
+
+            bool operator==(each_iterator const& other) const
+            {
+                return other.pos == pos;
+            }
+
+            bool operator!=(each_iterator const& other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+            pools_type pools{};
+            sparse_set const* view = nullptr;
+            details::excluded_sets excluded;
+            size_t pos = 0;
+            positions_type positions{};
+        };
+
+        class each_iterable
+        {
+        public:
+            each_iterable(each_iterator first, each_iterator last) : first{ first }, last{ last }
+            {}
+
+            each_iterator begin() const
+            {
+                return first;
+            }
+
+            each_iterator end() const
+            {
+                return last;
+            }
+
+        private:
+            each_iterator first;
+            each_iterator last;
         };
 
     public:
@@ -150,6 +409,10 @@ namespace Case_Engine::tecs
             : pools{ &components... }, view{ smallest_set() }
         {}
 
+        entity_view(details::excluded_sets const& excluded, component_pool<Cs>&... components)
+            : pools{ &components... }, view{ smallest_set() }, excluded{ excluded }
+        {}
+
         explicit operator bool() const
         {
             return view != nullptr;
@@ -157,26 +420,26 @@ namespace Case_Engine::tecs
 
         bool contains(entity e) const
         {
-            return (std::get<component_pool<Cs>*>(pools)->contains(e) && ...);
+            return (std::get<component_pool<Cs>*>(pools)->contains(e) && ...) && !excluded.rejects(e);
         }
 
         iterator begin() const
         {
-            return iterator(view->begin(), view->end(), view->begin(), get_unchecked(view));
+            return iterator(view->begin(), view->end(), view->begin(), get_unchecked(view), excluded);
         }
 
         iterator end() const
         {
-            return iterator(view->begin(), view->end(), view->end(), get_unchecked(view)); //
+            return iterator(view->begin(), view->end(), view->end(), get_unchecked(view), excluded); //
         }
 
         reverse_iterator rbegin() const
         {
-            return reverse_iterator(view->rbegin(), view->rend(), view->rbegin(), get_unchecked(view));
+            return reverse_iterator(view->rbegin(), view->rend(), view->rbegin(), get_unchecked(view), excluded);
         }
 
         reverse_iterator rend() const {
-            return reverse_iterator(view->rbegin(), view->rend(), view->rend(), get_unchecked(view));
+            return reverse_iterator(view->rbegin(), view->rend(), view->rend(), get_unchecked(view), excluded);
         }
 
         template <typename F> requires valid_each_function<F>
@@ -185,6 +448,63 @@ namespace Case_Engine::tecs
             for (auto& entity : *this) f(entity);
         }
 
+        template <typename F> requires valid_view_each_function<F, Cs...>
+        void each(F&& f)
+        {
+            for (auto&& components : each()) std::apply(f, components);
+        }
+
+        // for (auto [e, a, b] : view.each())
+        each_iterable each() const
+        {
+            return { each_iterator(pools, view, excluded, 0), each_iterator(pools, view, excluded, view ? view->size() : 0) };
+        }
+
+        template <typename C, typename F> requires valid_each_function<F>
+        void each_changed(tick_type since, F&& f)
+        {
+            static_assert(details::contains<std::remove_const_t<C>, Cs...>);
+            auto const* pool = std::get<component_pool<std::remove_const_t<C>>*>(pools);
+            for (auto& entity : *this) if (pool->changed(entity, since)) f(entity);
+        }
+
+        template<typename C>
+        bool changed(entity e, tick_type since) const
+        {
+            static_assert(details::contains<std::remove_const_t<C>, Cs...>);
+            return std::get<component_pool<std::remove_const_t<C>>*>(pools)->changed(e, since);
+        }
+
+        template <typename Executor, typename F> requires valid_executor<Executor> && valid_each_function<F>
+        void par_each(Executor& executor, F&& f, size_type chunk_size = details::default_chunk_size) const
+        {
+            auto const unchecked = get_unchecked(view);
+            entity const* entities = view->data();
+            details::parallel_chunks(executor, view->size(), chunk_size, [&](size_type first, size_type last)
+                {
+                    for (size_type pos = first; pos < last; ++pos)
+                    {
+                        entity const e = entities[pos];
+                        if (std::all_of(std::begin(unchecked), std::end(unchecked), [e](sparse_set const* curr) { return curr->contains(e); }) && !excluded.rejects(e)) f(e);
+                    }
+                });
+        }
+
+        template <typename Executor, typename T, typename F, typename R> requires valid_executor<Executor>
+        T par_reduce(Executor& executor, T identity, F&& f, R&& reduce, size_type chunk_size = details::default_chunk_size) const
+        {
+            auto const unchecked = get_unchecked(view);
+            entity const* entities = view->data();
+            return details::parallel_reduce_chunks(executor, view->size(), chunk_size, std::move(identity), [&](T& local, size_type first, size_type last)
+                {
+                    for (size_type pos = first; pos < last; ++pos)
+                    {
+                        entity const e = entities[pos];
+                        if (std::all_of(std::begin(unchecked), std::end(unchecked), [e](sparse_set const* curr) { return curr->contains(e); }) && !excluded.rejects(e)) f(local, e);
+                    }
+                }, reduce);
+        }
+
         template<typename... _Cs> requires (sizeof...(_Cs) != 1)
         decltype(auto) get(entity e) const
         {
@@ -212,6 +532,7 @@ namespace Case_Engine::tecs
     private:
         const std::tuple<component_pool<Cs>*...> pools;
         mutable sparse_set const* view;
+        details::excluded_sets excluded;
     };
 
 
@@ -221,8 +542,8 @@ namespace Case_Engine::tecs
     public:
         using component_type = C;
         using size_type = size_t;
-        using iterator = sparse_set::const_iterator;
-        using reverse_iterator = sparse_set::const_reverse_iterator;
+        using iterator = details::excluding_iterator<sparse_set::const_iterator>;
+        using reverse_iterator = details::excluding_iterator<sparse_set::const_reverse_iterator>;
 
     public:
 
@@ -234,6 +555,11 @@ namespace Case_Engine::tecs
             : pools{ &component_pool }
         {}
 
+        entity_view(details::excluded_sets const& excluded, component_pool<C>& component_pool)
+            : pools{ &component_pool }, excluded{ excluded }
+        {}
+
+        // packed size, excluded entities included
         size_type size() const
         {
             return std::get<0>(pools)->size();
@@ -246,22 +572,26 @@ namespace Case_Engine::tecs
 
         iterator begin() const
         {
-            return std::get<0>(pools)->begin();
+            auto const* pool = std::get<0>(pools);
+            return iterator(pool->begin(), pool->end(), pool->begin(), excluded);
         }
 
         iterator end() const
         {
-            return std::get<0>(pools)->end();
+            auto const* pool = std::get<0>(pools);
+            return iterator(pool->begin(), pool->end(), pool->end(), excluded);
         }
 
         reverse_iterator rbegin() const
         {
-            return std::get<0>(pools)->rbegin();
+            auto const* pool = std::get<0>(pools);
+            return reverse_iterator(pool->rbegin(), pool->rend(), pool->rbegin(), excluded);
         }
 
         reverse_iterator rend() const
         {
-            return std::get<0>(pools)->rend();
+            auto const* pool = std::get<0>(pools);
+            return reverse_iterator(pool->rbegin(), pool->rend(), pool->rend(), excluded);
         }
 
         template <typename F> requires valid_each_function<F>
@@ -270,9 +600,87 @@ namespace Case_Engine::tecs
             for (auto& entity : *this) f(entity);
         }
 
+        template <typename F> requires valid_view_each_function<F, component_type>
+        void each(F&& f)
+        {
+            auto* pool = std::get<0>(pools);
+            entity const* entities = pool->data();
+            for (size_type pos = 0, count = pool->size(); pos < count; ++pos)
+            {
+                if (excluded.rejects(entities[pos])) continue;
+                f(entities[pos], pool->get_at(pos));
+            }
+        }
+
+        template <typename F>
+        void each_changed(tick_type since, F&& f)
+        {
+            auto* pool = std::get<0>(pools);
+            for (size_type pos = 0; pos < pool->size(); ++pos)
+            {
+                if (!pool->changed_at(pos, since) || excluded.rejects(pool->at(pos))) continue;
+                if constexpr (std::is_invocable_v<F&, entity, component_type&>) f(pool->at(pos), pool->get_at(pos));
+                else f(pool->at(pos));
+            }
+        }
+
+        bool changed(entity e, tick_type since) const
+        {
+            return std::get<0>(pools)->changed(e, since);
+        }
+
+        bool any_changed(tick_type since) const
+        {
+            return std::get<0>(pools)->any_changed(since);
+        }
+
+        template <typename Executor, typename F> requires valid_executor<Executor>
+        void par_each(Executor& executor, F&& f, size_type chunk_size = details::default_chunk_size) const
+        {
+            auto* pool = std::get<0>(pools);
+            entity const* entities = pool->data();
+            details::parallel_chunks(executor, pool->size(), chunk_size, [&](size_type first, size_type last)
+                {
+                    for (size_type pos = first; pos < last; ++pos)
+                    {
+                        if (excluded.rejects(entities[pos])) continue;
+                        if constexpr (std::is_invocable_v<F&, entity, component_type&>) f(entities[pos], pool->get_at(pos));
+                        else f(entities[pos]);
+                    }
+                });
+        }
+
+        template <typename Executor, typename T, typename F, typename R> requires valid_executor<Executor>
+        T par_reduce(Executor& executor, T identity, F&& f, R&& reduce, size_type chunk_size = details::default_chunk_size) const
+        {
+            auto* pool = std::get<0>(pools);
+            entity const* entities = pool->data();
+            return details::parallel_reduce_chunks(executor, pool->size(), chunk_size, std::move(identity), [&](T& local, size_type first, size_type last)
+                {
+                    for (size_type pos = first; pos < last; ++pos)
+                    {
+                        if (excluded.rejects(entities[pos])) continue;
+                        if constexpr (std::is_invocable_v<F&, T&, entity, component_type&>) f(local, entities[pos], pool->get_at(pos));
+                        else f(local, entities[pos]);
+                    }
+                }, reduce);
+        }
+
+        // kernels over packed positions, pair with streams() or operator[]; excluded entities are not filtered
+        template <typename Executor, typename F> requires valid_executor<Executor>
+        void par_chunks(Executor& executor, F&& f, size_type chunk_size = details::default_chunk_size) const
+        {
+            details::parallel_chunks(executor, size(), chunk_size, [&](size_type first, size_type last) { f(first, last); });
+        }
+
+        auto streams() requires soa_component<component_type>
+        {
+            return std::get<0>(pools)->streams();
+        }
+
         entity operator[](size_type pos) const
         {
-            return begin()[pos];
+            return (*std::get<0>(pools))[pos];
         }
 
         explicit operator bool() const
@@ -282,13 +690,18 @@ namespace Case_Engine::tecs
 
         bool contains(entity e) const
         {
-            return std::get<0>(pools)->contains(e);
+            return std::get<0>(pools)->contains(e) && !excluded.rejects(e);
+        }
+
+        size_type index(entity e) const
+        {
+            return std::get<0>(pools)->index(e);
         }
 
 
         decltype(auto) get(entity e) const
         {
-            assert(contains(entity));
+            assert(contains(e));
             return const_cast<component_pool<component_type> const*>(std::get<0>(pools))->get(e);
         }
 
@@ -298,11 +711,22 @@ namespace Case_Engine::tecs
             return std::get<0>(pools)->get(e);
         }
 
+        component_type const* get_if(entity e) const
+        {
+            return contains(e) ? &get(e) : nullptr;
+        }
+
+        component_type* get_if(entity e)
+        {
+            return contains(e) ? &get(e) : nullptr;
+        }
+
         template<typename... Lhs, typename... Rhs>
         friend auto operator|(entity_view<Lhs...> const&, entity_view<Rhs...> const&);
 
     private:
         std::tuple<component_pool<component_type>*> const  pools;
+        details::excluded_sets excluded;
     };
 
 
@@ -310,7 +734,8 @@ namespace Case_Engine::tecs
     auto operator|(entity_view<Lhs...> const& lhs, entity_view<Rhs...> const& rhs)
     {
         using view_type = entity_view<Lhs..., Rhs...>;
-        return std::apply([](auto*... storage) { return view_type{ *storage... }; }, std::tuple_cat(
+        auto const excluded = lhs.excluded.merge(rhs.excluded);
+        return std::apply([&excluded](auto*... storage) { return view_type{ excluded, *storage... }; }, std::tuple_cat(
             lhs.pools, rhs.pools));
     }
 
@@ -0,0 +1,141 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "registry.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <iterator>
+#include <functional>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+	//component_traits<C> can declare template<typename F> static void remap(C&, F const& map);
+	//to rewrite entity references when a prefab is instantiated
+	template<typename C>
+	concept remappable_component = requires(C& c, std::function<entity(entity)> const& map)
+	{
+		component_traits<C>::remap(c, map);
+	};
+
+	//a captured set of entities and their components that can be instantiated many times.
+	//references to captured entities are remapped to the matching new entity of each copy, others are kept
+	class prefab
+	{
+		class block_base
+		{
+		public:
+			virtual ~block_base() = default;
+			virtual void instantiate(registry& reg, prefab const& owner, entity const* created, size_t copies) const = 0;
+		};
+
+		template<typename C>
+		class block : public block_base
+		{
+		public:
+			virtual void instantiate(registry& reg, prefab const& owner, entity const* created, size_t copies) const override
+			{
+				size_t const count = members.size() * copies;
+				std::vector<entity> targets;
+				std::vector<C> values;
+				targets.reserve(count);
+				values.reserve(count);
+
+				for (size_t copy = 0; copy < copies; ++copy)
+				{
+					entity const* copy_entities = created + copy * owner.size();
+					for (size_t i = 0; i < members.size(); ++i) targets.push_back(copy_entities[members[i]]);
+					values.insert(values.end(), components.begin(), components.end());
+
+					if constexpr (remappable_component<C>)
+					{
+						auto const map = [&owner, copy_entities](entity e) { return owner.remap(e, copy_entities); };
+						for (auto it = values.end() - members.size(); it != values.end(); ++it) component_traits<C>::remap(*it, map);
+					}
+				}
+				reg.insert<C>(targets.begin(), targets.end(), std::make_move_iterator(values.begin()));
+			}
+
+			std::vector<size_t> members;
+			std::vector<C> components;
+		};
+
+		entity remap(entity e, entity const* copy_entities) const
+		{
+			auto it = source_index.find(e);
+			return it != source_index.end() ? copy_entities[it->second] : e;
+		}
+
+	public:
+		prefab() = default;
+		prefab(prefab&&) = default;
+		prefab& operator=(prefab&&) = default;
+
+		template<typename... Cs, typename It> requires std::same_as<std::iter_value_t<It>, entity>
+		static prefab capture(registry& reg, It first, It last)
+		{
+			prefab result;
+			for (size_t i = 0; first != last; ++first, ++i)
+			{
+				assert(!result.source_index.contains(*first));
+				result.source_index.emplace(*first, i);
+				result.sources.push_back(*first);
+			}
+			(result.capture_block<Cs>(reg), ...);
+			return result;
+		}
+
+		//creates count copies, writes the new entities copy after copy in capture order
+		template<typename OutIt>
+		void instantiate(registry& reg, size_t count, OutIt out) const
+		{
+			std::vector<entity> created;
+			created.reserve(count * size());
+			reg.create(count * size(), std::back_inserter(created));
+			for (auto const& block : blocks) block->instantiate(reg, *this, created.data(), count);
+			std::copy(created.begin(), created.end(), out);
+		}
+
+		size_t size() const
+		{
+			return sources.size();
+		}
+
+		bool empty() const
+		{
+			return sources.empty();
+		}
+
+		void clear()
+		{
+			sources.clear();
+			source_index.clear();
+			blocks.clear();
+		}
+
+	private:
+		template<typename C>
+		void capture_block(registry& reg)
+		{
+			auto captured = std::make_unique<block<C>>();
+			for (size_t i = 0; i < sources.size(); ++i)
+			{
+				if (!reg.has<C>(sources[i])) continue;
+				captured->members.push_back(i);
+				captured->components.push_back(reg.get<C const>(sources[i]));
+			}
+			if (!captured->members.empty()) blocks.push_back(std::move(captured));
+		}
+
+	private:
+		std::vector<entity> sources;
+		std::unordered_map<entity, size_t> source_index;
+		std::vector<std::unique_ptr<block_base>> blocks;
+	};
+}
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 // Includes
 #pragma once
-#include "entity_view.h"
+#include "entity_group.h"
 #include <memory>
 #include <deque>
 
@@ -16,6 +16,9 @@ namespace Case_Engine::tecs
 
 	class registry
 	{
+		friend class snapshot;
+		friend class command_buffer;
+		friend class system_scheduler;
 		using component_id_t = size_t;
 
 		class component_id_generator
@@ -26,6 +29,58 @@ namespace Case_Engine::tecs
 			inline static const component_id_t type = counter++;
 		};
 
+		class group_handler
+		{
+		public:
+			virtual ~group_handler() = default;
+			virtual void on_construct(entity e) = 0;
+			virtual void on_destroy(entity e) = 0;
+			virtual void rebuild() = 0;
+
+			size_t length = 0;
+		};
+
+		template<typename... Cs>
+		class owning_group_handler final : public group_handler
+		{
+		public:
+			explicit owning_group_handler(component_pool<Cs>*... components) : pools{ components... }
+			{}
+
+			virtual void on_construct(entity e) override
+			{
+				if (!(std::get<component_pool<Cs>*>(pools)->contains(e) && ...)) return;
+				if (std::get<0>(pools)->index(e) < length) return;
+
+				(std::get<component_pool<Cs>*>(pools)->swap_at(std::get<component_pool<Cs>*>(pools)->index(e), length), ...);
+				++length;
+			}
+
+			virtual void on_destroy(entity e) override
+			{
+				auto const* lead = std::get<0>(pools);
+				if (!lead->contains(e) || lead->index(e) >= length) return;
+
+				--length;
+				(std::get<component_pool<Cs>*>(pools)->swap_at(std::get<component_pool<Cs>*>(pools)->index(e), length), ...);
+			}
+
+			virtual void rebuild() override
+			{
+				length = 0;
+				auto const* lead = std::get<0>(pools);
+				for (size_t pos = 0; pos < lead->size(); ++pos) on_construct(lead->at(pos));
+			}
+
+			entity_group<Cs...> handle() const
+			{
+				return std::apply([this](auto*... pool) { return entity_group<Cs...>{ length, *pool... }; }, pools);
+			}
+
+		private:
+			std::tuple<component_pool<Cs>*...> const pools;
+		};
+
 		template<typename C>
 		component_pool<C>* get_component_pool() const
 		{
@@ -35,7 +90,10 @@ namespace Case_Engine::tecs
 			if (component_id >= pools.size()) pools.resize(component_id + 1);
 
 			if (auto&& pool = pools[component_id]; !pool)
+			{
 				pool.reset(new component_pool<C>());
+				pool->set_tick(current_tick);
+			}
 
 			return static_cast<component_pool<C>*>(pools[component_id].get());
 		}
@@ -67,17 +125,41 @@ namespace Case_Engine::tecs
 			auto i = get_index(e);
 			auto v = get_version(e);
 
-			entities[i] = make_entity(get_index(next), v + 1);
+			entities[i] = make_entity(get_index(next), v + 1 == reserved_version ? 0 : v + 1);
 			next = make_entity(i);
 
 		}
 
+		template<typename C>
+		group_handler* get_group_owner() const
+		{
+			auto component_id = component_id_generator::template type<C>;
+			return component_id < group_owners.size() ? group_owners[component_id] : nullptr;
+		}
+
+		template<typename C>
+		void notify_construct(entity e)
+		{
+			if (auto* group = get_group_owner<C>()) group->on_construct(e);
+		}
+
+		template<typename C>
+		void notify_destroy(entity e)
+		{
+			if (auto* group = get_group_owner<C>()) group->on_destroy(e);
+		}
+
 		void remove_all(entity e)
 		{
 			assert(valid(e));
 
-			for (auto& pool : pools)
-				if (pool && pool->contains(e)) pool->remove(e);
+			for (component_id_t id = 0; id < pools.size(); ++id)
+			{
+				auto& pool = pools[id];
+				if (!pool || !pool->contains(e)) continue;
+				if (id < group_owners.size() && group_owners[id]) group_owners[id]->on_destroy(e);
+				pool->remove(e);
+			}
 		}
 	public:
 		using size_type = size_t;
@@ -93,7 +175,15 @@ namespace Case_Engine::tecs
 		[[maybe_unused]]
 		entity create()
 		{
-			return generate_entity(); // next == null_entity ? generate_entity() : recycle_entity(); bug with recycle_entity
+			return next == null_entity ? generate_entity() : recycle_entity();
+		}
+
+		template<typename It>
+		void create(size_type count, It out)
+		{
+			for (; count > 0 && next != null_entity; --count) *out++ = recycle_entity();
+			entities.reserve(entities.size() + count);
+			for (; count > 0; --count) *out++ = generate_entity();
 		}
 
 		void destroy(entity e)
@@ -103,13 +193,56 @@ namespace Case_Engine::tecs
 			e = null_entity;
 		}
 
+		template<typename It> requires std::same_as<std::iter_value_t<It>, entity>
+		void destroy(It first, It last)
+		{
+			//duplicates in the range are destroyed once, releasing a slot twice would hand it out twice
+			doomed.assign(entities.size(), false);
+			size_type count = 0;
+			for (auto it = first; it != last; ++it)
+			{
+				assert(valid(*it));
+				if (doomed[get_index(*it)]) continue;
+				doomed[get_index(*it)] = true;
+				++count;
+			}
+
+			for (component_id_t id = 0; id < pools.size(); ++id)
+			{
+				auto* pool = pools[id].get();
+				if (!pool || pool->empty()) continue;
+				auto* group = id < group_owners.size() ? group_owners[id] : nullptr;
+
+				auto const remove_one = [pool, group](entity e)
+				{
+					if (group) group->on_destroy(e);
+					pool->remove(e);
+				};
+
+				if (pool->size() < count)
+				{
+					for (size_type pos = pool->size(); pos-- > 0;)
+					{
+						if (entity e = pool->at(pos); doomed[get_index(e)]) remove_one(e);
+					}
+				}
+				else
+				{
+					for (auto it = first; it != last; ++it)
+						if (pool->contains(*it)) remove_one(*it);
+				}
+			}
+
+			for (auto it = first; it != last; ++it)
+				if (valid(*it)) release_entity(*it);
+		}
+
 		template<typename... Cs>
 		void destroy()
 		{
 			auto entities = view<Cs...>();
-			std::vector<entity> to_be_destroyed;
-			for (auto e : entities) to_be_destroyed.push_back(e);
-			for (auto e : to_be_destroyed) destroy(e);
+			destroy_buffer.assign(entities.begin(), entities.end());
+			destroy(destroy_buffer.begin(), destroy_buffer.end());
 		}
 
 		bool valid(entity e) const
@@ -118,6 +251,13 @@ namespace Case_Engine::tecs
 			return (pos < entities.size() && entities[pos] == e);
 		}
 
+		version_type current(entity e) const
+		{
+			auto pos = get_index(e);
+			assert(pos < entities.size());
+			return get_version(entities[pos]);
+		}
+
 		size_type alive() const
 		{
 			auto size = entities.size();
@@ -157,11 +297,36 @@ namespace Case_Engine::tecs
 			{
 				for (auto& pool : pools)
 					if (pool) pool->clear();
-				for (auto e : entities) release_entity(e);
 				entities.clear();
+				next = null_entity;
+				groups.clear();
+				group_owners.clear();
 				pools.clear();
 			}
-			else ([this](auto* pool) {pool->clear(); }(get_component_pool<Cs>()), ...);
+			else
+			{
+				([this](auto* pool) {pool->clear(); }(get_component_pool<Cs>()), ...);
+				([this](auto* group) { if (group) group->length = 0; }(get_group_owner<Cs>()), ...);
+			}
+		}
+
+		template<typename... Cs>
+		void reserve(size_type capacity)
+		{
+			if constexpr (sizeof...(Cs) == 0) entities.reserve(capacity);
+			else (get_component_pool<std::remove_const_t<Cs>>()->reserve(capacity), ...);
+		}
+
+		template<typename... Cs>
+		void shrink_to_fit()
+		{
+			if constexpr (sizeof...(Cs) == 0)
+			{
+				for (auto& pool : pools)
+					if (pool) pool->shrink_to_fit();
+				entities.shrink_to_fit();
+			}
+			else (get_component_pool<std::remove_const_t<Cs>>()->shrink_to_fit(), ...);
 		}
 
 		template<typename... Cs>
@@ -180,7 +345,11 @@ namespace Case_Engine::tecs
 		decltype(auto) get(entity e)
 		{
 			if constexpr (sizeof...(Cs) == 1)
-				return (const_cast<Cs&>(get_component_pool<std::remove_const_t<Cs>>()->get(e)), ...);
+			{
+				auto* pool = get_component_pool<std::remove_const_t<Cs>...>();
+				if constexpr (!(std::is_const_v<Cs> && ...)) pool->touch(e);
+				return (const_cast<Cs&>(pool->get(e)), ...);
+			}
 			else return std::forward_as_tuple(get<Cs>(e)...);
 		}
 
@@ -200,7 +369,12 @@ namespace Case_Engine::tecs
 		decltype(auto) get_if(entity e)
 		{
 			if constexpr (sizeof...(Cs) == 1)
-				return (const_cast<Cs*>(get_component_pool<std::remove_const_t<Cs>>()->get_if(e)), ...);
+			{
+				auto* pool = get_component_pool<std::remove_const_t<Cs>...>();
+				auto* component = pool->get_if(e);
+				if constexpr (!(std::is_const_v<Cs> && ...)) if (component) pool->touch(e);
+				return (const_cast<Cs*>(component), ...);
+			}
 			else return std::forward_as_tuple(get_if<Cs>(e)...);
 		}
 
@@ -209,6 +383,7 @@ namespace Case_Engine::tecs
 		{
 			assert(valid(e));
 			get_component_pool<std::remove_const_t<C>>()->emplace(e, std::forward<Args>(args)...);
+			notify_construct<std::remove_const_t<C>>(e);
 		}
 
 		template<typename C>
@@ -216,6 +391,23 @@ namespace Case_Engine::tecs
 		{
 			assert(valid(e));
 			get_component_pool<std::remove_const_t<C>>()->add(e, c);
+			notify_construct<std::remove_const_t<C>>(e);
+		}
+
+		template<typename C, typename It, typename CIt> requires std::same_as<std::iter_value_t<It>, entity> && std::input_iterator<CIt>
+		void insert(It first, It last, CIt from)
+		{
+			assert(std::all_of(first, last, [this](entity e) { return valid(e); }));
+			get_component_pool<std::remove_const_t<C>>()->insert(first, last, from);
+			for (; first != last; ++first) notify_construct<std::remove_const_t<C>>(*first);
+		}
+
+		template<typename C, typename It> requires std::same_as<std::iter_value_t<It>, entity>
+		void insert(It first, It last, C const& value = {})
+		{
+			assert(std::all_of(first, last, [this](entity e) { return valid(e); }));
+			get_component_pool<std::remove_const_t<C>>()->insert(first, last, value);
+			for (; first != last; ++first) notify_construct<std::remove_const_t<C>>(*first);
 		}
 
 		template<typename C, typename... Args>
@@ -239,12 +431,36 @@ namespace Case_Engine::tecs
 			return get_component_pool<std::remove_const_t<C>>()->update(e, std::forward<F>(func)...);
 		}
 
+		template<typename C>
+		void touch(entity e)
+		{
+			get_component_pool<std::remove_const_t<C>>()->touch(e);
+		}
+
+		template<typename... Cs>
+		void track(bool enable = true)
+		{
+			(get_component_pool<std::remove_const_t<Cs>>()->track(enable), ...);
+		}
+
+		tick_type tick() const
+		{
+			return current_tick;
+		}
+
+		void advance_tick()
+		{
+			++current_tick;
+			for (auto& pool : pools)
+				if (pool) pool->set_tick(current_tick);
+		}
+
 		template<typename... Cs>
 		void remove(entity e)
 		{
 			assert(valid(e));
 			if constexpr (sizeof...(Cs) == 0) remove_all(e);
-			else  (get_component_pool<std::remove_const_t<Cs>>()->remove(e), ...);
+			else  ((notify_destroy<std::remove_const_t<Cs>>(e), get_component_pool<std::remove_const_t<Cs>>()->remove(e)), ...);
 		}
 
 		template<typename C>
@@ -269,17 +485,64 @@ namespace Case_Engine::tecs
 			return [e](auto const*... pool) { return !((!pool || !pool->contains(e)) && ...); }(get_component_pool_if_exists<Cs>()...);
 		}
 
-		template<typename... Cs>
-		entity_view<Cs...> view()
+		template<typename C, typename Compare>
+		void sort(Compare compare)
+		{
+			assert(get_group_owner<C>() == nullptr && "Sort group owned pools through their group!");
+			get_component_pool<C>()->sort(std::move(compare));
+		}
+
+		template<typename To, typename From>
+		void sort()
+		{
+			assert(get_group_owner<To>() == nullptr && "Sort group owned pools through their group!");
+			auto const* from = get_component_pool<From>();
+			get_component_pool<To>()->respect(*from, from->size());
+		}
+
+		template<typename... Cs, typename... Es>
+		entity_view<Cs...> view(exclude_t<Es...> = {})
 		{
 			static_assert(sizeof...(Cs) > 0);
-			return { *get_component_pool<std::remove_const_t<Cs>>()... };
+			return { details::excluded_sets{ get_component_pool<std::remove_const_t<Es>>()... }, *get_component_pool<std::remove_const_t<Cs>>()... };
+		}
+
+		template<typename... Cs>
+		entity_group<Cs...> group()
+		{
+			static_assert(sizeof...(Cs) > 1, "Group has to own at least two component types!");
+			static_assert((std::same_as<Cs, std::decay_t<Cs>> && ...), "Non-decayed Component types are not allowed!");
+			using handler_type = owning_group_handler<Cs...>;
+
+			if (auto* owner = get_group_owner<std::tuple_element_t<0, std::tuple<Cs...>>>())
+			{
+				auto* handler = dynamic_cast<handler_type*>(owner);
+				assert(handler && "Component pool is already owned by a different group!");
+				return handler->handle();
+			}
+			assert(((get_group_owner<Cs>() == nullptr) && ...) && "Component pool is already owned by a different group!");
+
+			auto& handler = groups.emplace_back(std::make_unique<handler_type>(get_component_pool<Cs>()...));
+			([this, owner = handler.get()](component_id_t id)
+				{
+					if (id >= group_owners.size()) group_owners.resize(id + 1);
+					group_owners[id] = owner;
+				}(component_id_generator::template type<Cs>), ...);
+
+			handler->rebuild();
+			return static_cast<handler_type*>(handler.get())->handle();
 		}
 
 	private:
 		std::vector<entity>	entities;
 		entity next = null_entity;
+		tick_type current_tick = 0;
 		mutable std::vector<std::unique_ptr<sparse_set>> pools;
+		std::vector<std::unique_ptr<group_handler>> groups;
+		std::vector<group_handler*> group_owners;
+		//scratch for the destroy overloads, kept so repeated destroys do not allocate
+		std::vector<entity> destroy_buffer;
+		std::vector<bool> doomed;
 
 	};
 
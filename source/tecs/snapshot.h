@@ -0,0 +1,202 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "registry.h"
+#include <string>
+#include <cstring>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+
+	class snapshot_archive
+	{
+	public:
+		snapshot_archive() = default;
+		explicit snapshot_archive(std::vector<std::byte> bytes) : bytes{ std::move(bytes) }
+		{}
+
+		void write(void const* src, size_t size)
+		{
+			auto const* first = static_cast<std::byte const*>(src);
+			bytes.insert(bytes.end(), first, first + size);
+		}
+
+		void read(void* dst, size_t size)
+		{
+			assert(cursor + size <= bytes.size());
+			std::memcpy(dst, bytes.data() + cursor, size);
+			cursor += size;
+		}
+
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		void write(T const& value)
+		{
+			write(&value, sizeof(T));
+		}
+
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		void read(T& value)
+		{
+			read(&value, sizeof(T));
+		}
+
+		void write(std::string const& value)
+		{
+			write(static_cast<uint64_t>(value.size()));
+			write(value.data(), value.size());
+		}
+
+		void read(std::string& value)
+		{
+			uint64_t size{};
+			read(size);
+			value.resize(size);
+			read(value.data(), size);
+		}
+
+		//shared objects are stored by reference, archives holding any can only be restored in the same process
+		template<typename T>
+		void write(std::shared_ptr<T> const& object)
+		{
+			write(static_cast<uint32_t>(objects.size()));
+			objects.push_back(object);
+		}
+
+		template<typename T>
+		void read(std::shared_ptr<T>& object)
+		{
+			uint32_t index{};
+			read(index);
+			assert(index < objects.size());
+			object = std::static_pointer_cast<T>(objects[index]);
+		}
+
+		bool portable() const
+		{
+			return objects.empty();
+		}
+
+		bool empty() const
+		{
+			return bytes.empty();
+		}
+
+		std::vector<std::byte> const& data() const
+		{
+			return bytes;
+		}
+
+		void rewind()
+		{
+			cursor = 0;
+		}
+
+		void clear()
+		{
+			bytes.clear();
+			objects.clear();
+			cursor = 0;
+		}
+
+	private:
+		std::vector<std::byte> bytes;
+		std::vector<std::shared_ptr<void>> objects;
+		size_t cursor = 0;
+	};
+
+	template<typename C>
+	struct snapshot_traits
+	{
+		static_assert(std::is_trivially_copyable_v<C>, "Specialize snapshot_traits for non-trivially copyable components!");
+
+		static void save(snapshot_archive& archive, C const* components, size_t count)
+		{
+			archive.write(components, count * sizeof(C));
+		}
+
+		static void load(snapshot_archive& archive, C* components, size_t count)
+		{
+			archive.read(components, count * sizeof(C));
+		}
+	};
+
+	class snapshot
+	{
+		static constexpr uint32_t magic = 0x53434554; //TECS
+
+		template<typename C>
+		static void save_pool(registry const& reg, snapshot_archive& archive)
+		{
+			auto const* pool = reg.get_component_pool_if_exists<C>();
+			uint64_t const count = pool ? pool->size() : 0;
+
+			archive.write(static_cast<uint32_t>(sizeof(C)));
+			archive.write(count);
+			if (count == 0) return;
+
+			archive.write(pool->data(), count * sizeof(entity));
+			if constexpr (requires { pool->raw(); }) snapshot_traits<C>::save(archive, pool->raw(), count);
+			else for (size_t pos = 0; pos < count; ++pos) snapshot_traits<C>::save(archive, &pool->get_at(pos), 1);
+		}
+
+		template<typename C>
+		static void load_pool(registry& reg, snapshot_archive& archive)
+		{
+			uint32_t component_size{};
+			uint64_t count{};
+			archive.read(component_size);
+			archive.read(count);
+			assert(component_size == sizeof(C) && "Snapshot was saved with a different component layout!");
+			if (count == 0) return;
+
+			std::vector<entity> packed(count);
+			archive.read(packed.data(), count * sizeof(entity));
+			auto* pool = reg.get_component_pool<C>();
+			pool->assign(packed.data(), count);
+			if constexpr (requires { pool->raw(); }) snapshot_traits<C>::load(archive, pool->raw(), count);
+			else for (size_t pos = 0; pos < count; ++pos) snapshot_traits<C>::load(archive, &pool->get_at(pos), 1);
+		}
+
+	public:
+		//only the listed component types are stored, in the listed order; load has to use the same list
+		template<typename... Cs>
+		static void save(registry const& reg, snapshot_archive& archive)
+		{
+			static_assert((std::same_as<Cs, std::decay_t<Cs>> && ...), "Non-decayed Component types are not allowed!");
+
+			archive.write(magic);
+			archive.write(static_cast<uint64_t>(reg.entities.size()));
+			archive.write(reg.entities.data(), reg.entities.size() * sizeof(entity));
+			archive.write(reg.next);
+			(save_pool<Cs>(reg, archive), ...);
+		}
+
+		template<typename... Cs>
+		static void load(registry& reg, snapshot_archive& archive)
+		{
+			static_assert((std::same_as<Cs, std::decay_t<Cs>> && ...), "Non-decayed Component types are not allowed!");
+
+			uint32_t header{};
+			archive.read(header);
+			assert(header == magic && "Not a registry snapshot!");
+
+			uint64_t count{};
+			archive.read(count);
+			reg.entities.resize(count);
+			archive.read(reg.entities.data(), count * sizeof(entity));
+			archive.read(reg.next);
+
+			for (auto& pool : reg.pools)
+				if (pool) pool->clear();
+			(load_pool<Cs>(reg, archive), ...);
+			for (auto& group : reg.groups) group->rebuild();
+		}
+	};
+
+}
\ No newline at end of file
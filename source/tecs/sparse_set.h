@@ -7,15 +7,51 @@
 #pragma once
 #include "entity.h"
 #include <vector>
+#include <memory>
+#include <algorithm>
 #include <cassert>
 
 
 // Namespace Case_Engine
 namespace Case_Engine::tecs
 {
+	using tick_type = uint32_t;
 
 	class sparse_set
 	{
+		using position_type = uint32_t;
+		using page_type = std::unique_ptr<position_type[]>;
+
+		static constexpr position_type null_position = static_cast<position_type>(-1);
+
+		position_type const* sparse_ptr(entity e) const
+		{
+			auto const index = get_index(e);
+			auto const page = index / page_size;
+			return page < sparse_pages.size() && sparse_pages[page] ? &sparse_pages[page][index % page_size] : nullptr;
+		}
+
+		position_type& sparse_ref(entity e)
+		{
+			auto const index = get_index(e);
+			assert(index / page_size < sparse_pages.size() && sparse_pages[index / page_size]);
+			return sparse_pages[index / page_size][index % page_size];
+		}
+
+		position_type& assure_page(entity e)
+		{
+			auto const index = get_index(e);
+			auto const page = index / page_size;
+
+			if (page >= sparse_pages.size()) sparse_pages.resize(page + 1);
+			if (!sparse_pages[page])
+			{
+				sparse_pages[page] = std::make_unique_for_overwrite<position_type[]>(page_size);
+				std::fill_n(sparse_pages[page].get(), page_size, null_position);
+			}
+			return sparse_pages[page][index % page_size];
+		}
+
 	public:
 		using size_type = size_t;
 		using iterator = std::vector<entity>::iterator;
@@ -23,11 +59,26 @@ namespace Case_Engine::tecs
 		using reverse_iterator = std::vector<entity>::reverse_iterator;
 		using const_reverse_iterator = std::vector<entity>::const_reverse_iterator;
 
+		static constexpr size_type page_size = 4096;
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
 	public:
 		sparse_set() = default;
-		sparse_set(sparse_set const&) = default;
+		sparse_set(sparse_set const& other) : sparse_pages(other.sparse_pages.size()), packed_array{ other.packed_array }
+		{
+			for (size_type page = 0; page < other.sparse_pages.size(); ++page)
+			{
+				if (!other.sparse_pages[page]) continue;
+				sparse_pages[page] = std::make_unique_for_overwrite<position_type[]>(page_size);
+				std::copy_n(other.sparse_pages[page].get(), page_size, sparse_pages[page].get());
+			}
+		}
 		sparse_set(sparse_set&&) = default;
-		sparse_set& operator=(sparse_set const&) = default;
+		sparse_set& operator=(sparse_set const& other)
+		{
+			if (this != &other) *this = sparse_set(other);
+			return *this;
+		}
 		sparse_set& operator=(sparse_set&&) = default;
 		virtual ~sparse_set() = default;
 
@@ -36,6 +87,16 @@ namespace Case_Engine::tecs
 			return packed_array.size();
 		}
 
+		tick_type tick() const
+		{
+			return current_tick;
+		}
+
+		void set_tick(tick_type t)
+		{
+			current_tick = t;
+		}
+
 		bool empty() const
 		{
 			return packed_array.empty();
@@ -43,40 +104,111 @@ namespace Case_Engine::tecs
 
 		void emplace(entity e)
 		{
-			auto pos = packed_array.size();
-			auto index = get_index(e);
+			assert(packed_array.size() < null_position);
+			auto pos = static_cast<position_type>(packed_array.size());
 
 			packed_array.push_back(e);
+			assure_page(e) = pos;
+		}
 
-			if (sparse_array.size() <= index)
-				sparse_array.resize(index + 1);
-
-			sparse_array[index] = pos;
+		template<typename It> requires std::same_as<std::iter_value_t<It>, entity>
+		void insert(It first, It last)
+		{
+			auto pos = static_cast<position_type>(packed_array.size());
+			packed_array.insert(packed_array.end(), first, last);
+			assert(packed_array.size() < null_position);
+
+			for (; first != last; ++first)
+			{
+				assert(!contains(*first));
+				assure_page(*first) = pos++;
+			}
 		}
 
 		bool contains(entity e) const
 		{
-			auto index = get_index(e);
+			return find(e) != npos;
+		}
 
-			return index < sparse_array.size() && sparse_array[index] < packed_array.size()
-				&& packed_array[sparse_array[index]] == e;
+		//packed position of e, npos if e is not in the set
+		size_type find(entity e) const
+		{
+			auto const* pos = sparse_ptr(e);
+			return pos && *pos != null_position && packed_array[*pos] == e ? *pos : npos;
 		}
 
 		virtual void remove(entity e)
 		{
 			if (!contains(e)) return;
-			auto index = as_integer(e);
-			auto last = as_integer(packed_array.back());
-			std::swap(packed_array.back(), packed_array[sparse_array[index]]);
-			std::swap(sparse_array[last], sparse_array[index]);
+			auto& pos = sparse_ref(e);
+			auto const last = packed_array.back();
+
+			packed_array[pos] = last;
+			sparse_ref(last) = pos;
+			pos = null_position;
 			packed_array.pop_back();
 		}
 
 		virtual void clear()
 		{
+			sparse_pages.clear();
 			packed_array.clear();
 		}
 
+		//sparse pages follow entity indices rather than the element count, they are still allocated on insert
+		virtual void reserve(size_type capacity)
+		{
+			packed_array.reserve(capacity);
+		}
+
+		virtual void shrink_to_fit()
+		{
+			packed_array.shrink_to_fit();
+
+			std::vector<bool> used(sparse_pages.size());
+			for (auto e : packed_array) used[get_index(e) / page_size] = true;
+			for (size_type page = 0; page < sparse_pages.size(); ++page)
+				if (!used[page]) sparse_pages[page].reset();
+
+			while (!sparse_pages.empty() && !sparse_pages.back()) sparse_pages.pop_back();
+			sparse_pages.shrink_to_fit();
+		}
+
+		virtual void swap_at(size_type lhs, size_type rhs)
+		{
+			assert(lhs < packed_array.size() && rhs < packed_array.size());
+			auto& from = packed_array[lhs];
+			auto& to = packed_array[rhs];
+			std::swap(sparse_ref(from), sparse_ref(to));
+			std::swap(from, to);
+		}
+
+		template<typename Compare> requires std::is_invocable_r_v<bool, Compare&, entity, entity>
+		bool sort_n(size_type count, Compare compare)
+		{
+			return sort_positions(count, [this, &compare](size_type lhs, size_type rhs) { return compare(packed_array[lhs], packed_array[rhs]); });
+		}
+
+		template<typename Compare> requires std::is_invocable_r_v<bool, Compare&, entity, entity>
+		void sort(Compare compare)
+		{
+			sort_n(size(), std::move(compare));
+		}
+
+		//moves the entities shared with the first count entities of other to the front, in the same order
+		void respect(sparse_set const& other, size_type count)
+		{
+			assert(count <= other.size());
+			size_type pos = 0;
+			for (size_type i = 0; i < count; ++i)
+			{
+				entity const e = other.packed_array[i];
+				if (!contains(e)) continue;
+				if (auto const curr = index(e); curr != pos) swap_at(curr, pos);
+				++pos;
+			}
+		}
+
 		entity at(size_type pos) const
 		{
 			return pos < packed_array.size() ? packed_array[pos] : null_entity;
@@ -91,7 +223,12 @@ namespace Case_Engine::tecs
 		size_type index(entity e) const
 		{
 			assert(contains(e));
-			return sparse_array[get_index(e)];
+			return *sparse_ptr(e);
+		}
+
+		entity const* data() const
+		{
+			return packed_array.data();
 		}
 
 		iterator begin()
@@ -154,8 +291,50 @@ namespace Case_Engine::tecs
 			return rend();
 		}
 
+	protected:
+		//insertion sort through swap_at, linear on nearly sorted sets;
+		//falls back to a full sort applied as a permutation when the set is far from sorted, returns whether anything moved
+		template<typename Less>
+		bool sort_positions(size_type count, Less less)
+		{
+			assert(count <= packed_array.size());
+			size_type const budget = count * 8;
+			size_type moves = 0;
+			for (size_type i = 1; i < count; ++i)
+			{
+				for (size_type j = i; j > 0 && less(j, j - 1); --j)
+				{
+					if (++moves > budget)
+					{
+						std::vector<size_type> order(count);
+						for (size_type pos = 0; pos < count; ++pos) order[pos] = pos;
+						std::sort(order.begin(), order.end(), less);
+
+						for (size_type pos = 0; pos < count; ++pos)
+						{
+							size_type curr = pos;
+							size_type next = order[curr];
+							while (next != pos)
+							{
+								swap_at(curr, next);
+								order[curr] = curr;
+								curr = next;
+								next = order[curr];
+							}
+							order[curr] = curr;
+						}
+						return true;
+					}
+					swap_at(j, j - 1);
+				}
+			}
+			return moves > 0;
+		}
+
+		tick_type current_tick = 0;
+
 	private:
-		std::vector<size_type>	sparse_array;
+		std::vector<page_type>	sparse_pages;
 		std::vector<entity>		packed_array;
 	};
 
@@ -0,0 +1,217 @@
+//-----------------------------------------------------
+//  Copyright 2024 Case Engine. All Rights Reserved. 
+//-----------------------------------------------------
+
+
+// Includes
+#pragma once
+#include "registry.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+
+// Namespace Case_Engine
+namespace Case_Engine::tecs
+{
+	template<typename... Cs>
+	struct reads_t {};
+
+	template<typename... Cs>
+	inline constexpr reads_t<Cs...> reads{};
+
+	template<typename... Cs>
+	struct writes_t {};
+
+	template<typename... Cs>
+	inline constexpr writes_t<Cs...> writes{};
+
+	enum class system_affinity : uint8_t
+	{
+		any,
+		main_thread
+	};
+
+	struct system_timing
+	{
+		std::string name;
+		float time_in_ms = 0.0f;
+	};
+
+	//runs systems in insertion order except where their declared component accesses allow overlap:
+	//a system waits for every earlier system it conflicts with (write/write or read/write on the same component).
+	//main_thread systems run on the caller in insertion order, the rest are submitted to the executor.
+	//systems that fan out onto the same executor themselves should be main_thread to avoid starving its workers.
+	//structural changes (create/destroy/emplace/remove) inside systems must go through command buffers
+	class system_scheduler
+	{
+		using component_id_t = registry::component_id_t;
+
+		struct system
+		{
+			std::string name;
+			std::function<void()> callback;
+			std::vector<component_id_t> reads;
+			std::vector<component_id_t> writes;
+			system_affinity affinity;
+			std::vector<size_t> dependents;
+			size_t dependencies = 0;
+		};
+
+		static bool overlaps(std::vector<component_id_t> const& lhs, std::vector<component_id_t> const& rhs)
+		{
+			return std::any_of(lhs.begin(), lhs.end(), [&rhs](component_id_t id) { return std::find(rhs.begin(), rhs.end(), id) != rhs.end(); });
+		}
+
+		static bool conflicts(system const& lhs, system const& rhs)
+		{
+			return overlaps(lhs.writes, rhs.writes) || overlaps(lhs.writes, rhs.reads) || overlaps(lhs.reads, rhs.writes);
+		}
+
+		void build()
+		{
+			for (auto& s : systems)
+			{
+				s.dependents.clear();
+				s.dependencies = 0;
+			}
+			size_t last_main = systems.size();
+			for (size_t j = 0; j < systems.size(); ++j)
+			{
+				bool const main = systems[j].affinity == system_affinity::main_thread;
+				for (size_t i = 0; i < j; ++i)
+				{
+					if (!conflicts(systems[i], systems[j]) && !(main && i == last_main)) continue;
+					systems[i].dependents.push_back(j);
+					++systems[j].dependencies;
+				}
+				if (main) last_main = j;
+			}
+			dirty = false;
+		}
+
+	public:
+		explicit system_scheduler(registry& reg) : reg{ reg }
+		{}
+
+		//pools of the declared components are created here so that systems never create them concurrently
+		template<typename... Rs, typename... Ws, typename F> requires std::is_invocable_v<F&>
+		void add(std::string name, reads_t<Rs...>, writes_t<Ws...>, F&& f, system_affinity affinity = system_affinity::any)
+		{
+			(reg.get_component_pool<std::remove_const_t<Rs>>(), ...);
+			(reg.get_component_pool<std::remove_const_t<Ws>>(), ...);
+
+			timings.push_back(system_timing{ name });
+			systems.push_back(system{ std::move(name), std::forward<F>(f),
+				{ registry::component_id_generator::template type<std::remove_const_t<Rs>>... },
+				{ registry::component_id_generator::template type<std::remove_const_t<Ws>>... }, affinity });
+			dirty = true;
+		}
+
+		template<typename Executor> requires valid_executor<Executor>
+		void run(Executor& executor)
+		{
+			if (dirty) build();
+
+			std::vector<size_t> remaining(systems.size());
+			std::vector<size_t> ready_main, ready_any;
+			for (size_t i = 0; i < systems.size(); ++i)
+			{
+				remaining[i] = systems[i].dependencies;
+				if (remaining[i] == 0) (systems[i].affinity == system_affinity::main_thread ? ready_main : ready_any).push_back(i);
+			}
+
+			std::mutex mutex;
+			std::condition_variable finished_cv;
+			std::vector<size_t> finished;
+			std::vector<decltype(executor.Submit(std::declval<void(*)()>()))> pending;
+			pending.reserve(systems.size());
+
+			auto execute = [this](size_t i)
+				{
+					auto const start = std::chrono::steady_clock::now();
+					systems[i].callback();
+					timings[i].time_in_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+				};
+			auto complete = [&](size_t i)
+				{
+					for (size_t dependent : systems[i].dependents)
+					{
+						if (--remaining[dependent] != 0) continue;
+						(systems[dependent].affinity == system_affinity::main_thread ? ready_main : ready_any).push_back(dependent);
+					}
+				};
+
+			size_t done = 0;
+			while (done < systems.size())
+			{
+				for (size_t i : ready_any)
+				{
+					pending.push_back(executor.Submit([&, i]()
+						{
+							execute(i);
+							std::lock_guard lock(mutex);
+							finished.push_back(i);
+							finished_cv.notify_one();
+						}));
+				}
+				ready_any.clear();
+
+				if (!ready_main.empty())
+				{
+					size_t const i = ready_main.back();
+					ready_main.pop_back();
+					execute(i);
+					complete(i);
+					++done;
+				}
+				else
+				{
+					std::vector<size_t> batch;
+					{
+						std::unique_lock lock(mutex);
+						finished_cv.wait(lock, [&finished]() { return !finished.empty(); });
+						batch.swap(finished);
+					}
+					for (size_t i : batch) complete(i);
+					done += batch.size();
+				}
+
+				std::vector<size_t> batch;
+				{
+					std::lock_guard lock(mutex);
+					batch.swap(finished);
+				}
+				for (size_t i : batch) complete(i);
+				done += batch.size();
+			}
+			for (auto& result : pending) result.wait();
+		}
+
+		std::vector<system_timing> const& get_timings() const
+		{
+			return timings;
+		}
+
+		size_t size() const
+		{
+			return systems.size();
+		}
+
+		void clear()
+		{
+			systems.clear();
+			timings.clear();
+			dirty = true;
+		}
+
+	private:
+		registry& reg;
+		std::vector<system> systems;
+		std::vector<system_timing> timings;
+		bool dirty = true;
+	};
+}
\ No newline at end of file